@@ -0,0 +1,320 @@
+/*
+ * domain.c — Implementacion de domain.h con shm_open, fork y futex(2).
+ *
+ * Disposicion de la memoria compartida (un solo mapeo):
+ *   - Encabezado: la barrera, el flag de falla y el tiempo medido,
+ *     redondeado a una linea de cache.
+ *   - Halos: [paridad][proceso][arriba/abajo][width] bytes, la primera y
+ *     la ultima fila de cada franja en cada paridad.
+ *   - Grid: width * height bytes.
+ * El nombre del objeto se borra con shm_unlink apenas se mapea: el
+ * mapeo sigue valido y los hijos lo heredan con fork, pero no queda
+ * nada en /dev/shm aunque el proceso muera.
+ *
+ * Cada hijo aloca su Game despues del fork, asi sus paginas se tocan
+ * por primera vez desde el nodo NUMA donde corre el hijo. No se fija la
+ * afinidad: se deja al scheduler del kernel.
+ */
+
+#define _DEFAULT_SOURCE  /* syscall, ftruncate, clock_gettime */
+
+#include <stdlib.h>  /* malloc, calloc, free */
+#include "domain.h"
+
+#ifdef __linux__
+
+#include <stdio.h>            /* snprintf, fflush */
+#include <stdint.h>           /* uint32_t */
+#include <limits.h>           /* INT_MAX */
+#include <time.h>             /* clock_gettime */
+#include <errno.h>            /* errno, EINTR */
+#include <fcntl.h>            /* O_CREAT, O_EXCL, O_RDWR */
+#include <signal.h>           /* kill, SIGKILL */
+#include <unistd.h>           /* fork, _exit, ftruncate, close, getpid, syscall */
+#include <sys/mman.h>         /* shm_open, shm_unlink, mmap, munmap */
+#include <sys/wait.h>         /* waitpid */
+#include <sys/syscall.h>      /* SYS_futex */
+#include <linux/futex.h>      /* FUTEX_WAIT, FUTEX_WAKE */
+
+/* Lecturas de la fase antes de dormir en el futex */
+#define BARRIER_SPINS 1000
+
+/*
+ * DomainBarrier — Barrera reutilizable entre procesos. arrived cuenta
+ * los que llegaron en la fase actual; el ultimo lo vuelve a 0 antes de
+ * avanzar phase, que es la palabra sobre la que duermen los demas.
+ */
+typedef struct {
+    uint32_t arrived;
+    uint32_t phase;
+} DomainBarrier;
+
+typedef struct {
+    DomainBarrier barrier;
+    int failed;            /* Algun proceso no pudo preparar su franja */
+    double elapsed;        /* Segundos medidos por el proceso 0 */
+} DomainHeader;
+
+/* Encabezado redondeado a una linea de cache */
+#define HEADER_BYTES ((sizeof(DomainHeader) + 63) / 64 * 64)
+
+struct Domain {
+    int width, height, nprocs;
+    size_t size;           /* Bytes del mapeo */
+    DomainHeader *header;
+    unsigned char *halos;
+    unsigned char *grid;
+};
+
+int domain_supported(void) {
+    return 1;
+}
+
+Domain *domain_create(int width, int height, int nprocs) {
+    static unsigned serial;
+    Domain *d;
+    char name[64];
+    void *base;
+    int fd;
+    if (width <= 0 || height <= 0 || nprocs <= 0) return NULL;
+    d = malloc(sizeof(Domain));
+    if (!d) return NULL;
+    d->width = width;
+    d->height = height;
+    d->nprocs = nprocs < height ? nprocs : height;
+    d->size = HEADER_BYTES + (size_t)2 * d->nprocs * 2 * width + (size_t)width * height;
+
+    snprintf(name, sizeof(name), "/gol-domain-%ld-%u", (long)getpid(), serial++);
+    fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        free(d);
+        return NULL;
+    }
+    shm_unlink(name);
+    if (ftruncate(fd, (off_t)d->size) != 0) {
+        close(fd);
+        free(d);
+        return NULL;
+    }
+    base = mmap(NULL, d->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        free(d);
+        return NULL;
+    }
+    d->header = base;
+    d->halos = (unsigned char *)base + HEADER_BYTES;
+    d->grid = d->halos + (size_t)2 * d->nprocs * 2 * width;
+    return d;
+}
+
+void domain_destroy(Domain *d) {
+    if (!d) return;
+    munmap(d->header, d->size);
+    free(d);
+}
+
+int domain_procs(const Domain *d) {
+    return d->nprocs;
+}
+
+unsigned char *domain_grid(Domain *d) {
+    return d->grid;
+}
+
+double domain_elapsed(const Domain *d) {
+    return d->header->elapsed;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * barrier_wait — Espera a que lleguen los n procesos. La fase se lee
+ * antes de anotarse: si el ultimo la avanza entre medio, FUTEX_WAIT ve
+ * un valor distinto y vuelve enseguida. Los futex no son privados
+ * porque la palabra esta en un mapeo compartido entre procesos.
+ */
+static void barrier_wait(DomainBarrier *b, uint32_t n) {
+    uint32_t phase = __atomic_load_n(&b->phase, __ATOMIC_ACQUIRE);
+    int spin;
+    if (__atomic_add_fetch(&b->arrived, 1, __ATOMIC_ACQ_REL) == n) {
+        __atomic_store_n(&b->arrived, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&b->phase, phase + 1, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &b->phase, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+        return;
+    }
+    for (spin = 0; spin < BARRIER_SPINS; spin++)
+        if (__atomic_load_n(&b->phase, __ATOMIC_ACQUIRE) != phase) return;
+    while (__atomic_load_n(&b->phase, __ATOMIC_ACQUIRE) == phase)
+        syscall(SYS_futex, &b->phase, FUTEX_WAIT, phase, NULL, NULL, 0);
+}
+
+/*
+ * slab_start — Primera fila de la franja rank; la franja nprocs es el
+ * alto del grid. Las franjas difieren a lo sumo en una fila.
+ */
+static int slab_start(const Domain *d, int rank) {
+    return (int)((long long)rank * d->height / d->nprocs);
+}
+
+/*
+ * halo — Fila publicada por el proceso rank en la paridad dada: side 0
+ * es su primera fila, side 1 la ultima.
+ */
+static unsigned char *halo(const Domain *d, int parity, int rank, int side) {
+    return d->halos + (((size_t)parity * d->nprocs + rank) * 2 + side) * d->width;
+}
+
+/*
+ * run_slab — Cuerpo de cada hijo. El Game local tiene las filas de la
+ * franja mas una fila de halo por cada vecino. Aunque no pueda alocar,
+ * el hijo pasa por la barrera de arranque: asi todos ven el flag de
+ * falla y terminan, sin que nadie quede esperando.
+ * Retorna 1 en exito.
+ */
+static int run_slab(Domain *d, const DomainConfig *cfg, int rank) {
+    DomainHeader *hd = d->header;
+    uint32_t n = (uint32_t)d->nprocs;
+    int w = d->width, y0 = slab_start(d, rank), rows = slab_start(d, rank + 1) - y0;
+    int top = rank > 0, bottom = rank < d->nprocs - 1;
+    Game *g = game_create_ex(w, top + rows + bottom, cfg->alloc);
+    double t0 = 0;
+    long gen;
+
+    if (g) {
+        game_set_threads(g, cfg->threads);  /* Si falla, la franja corre en un thread */
+        game_set_engine(g, cfg->engine);
+        game_write_region(g, 0, 0, w, top + rows + bottom, d->grid + (size_t)(y0 - top) * w, w,
+                          GAME_BLEND_COPY);
+    } else {
+        __atomic_store_n(&hd->failed, 1, __ATOMIC_RELAXED);
+    }
+    barrier_wait(&hd->barrier, n);
+    if (__atomic_load_n(&hd->failed, __ATOMIC_RELAXED)) {
+        game_destroy(g);
+        return 0;
+    }
+
+    if (rank == 0) t0 = now_seconds();
+    for (gen = 0; gen < cfg->generations; gen++) {
+        int parity = (int)(gen & 1);
+        game_step(g);
+        if (top) game_read_region(g, 0, top, w, 1, halo(d, parity, rank, 0), w);
+        if (bottom) game_read_region(g, 0, top + rows - 1, w, 1, halo(d, parity, rank, 1), w);
+        barrier_wait(&hd->barrier, n);
+        if (top)
+            game_write_region(g, 0, 0, w, 1, halo(d, parity, rank - 1, 1), w, GAME_BLEND_COPY);
+        if (bottom)
+            game_write_region(g, 0, top + rows, w, 1, halo(d, parity, rank + 1, 0), w,
+                              GAME_BLEND_COPY);
+    }
+    barrier_wait(&hd->barrier, n);
+    if (rank == 0) hd->elapsed = now_seconds() - t0;
+
+    game_read_region(g, 0, top, w, rows, d->grid + (size_t)y0 * w, w);
+    game_destroy(g);
+    return 1;
+}
+
+/*
+ * kill_running — Termina los hijos que todavia no se recogieron.
+ */
+static void kill_running(const pid_t *pids, int count) {
+    int i;
+    for (i = 0; i < count; i++)
+        if (pids[i] > 0) kill(pids[i], SIGKILL);
+}
+
+int domain_run(Domain *d, const DomainConfig *cfg) {
+    pid_t *pids = calloc((size_t)d->nprocs, sizeof(pid_t));
+    int started, running, ok = 1;
+    if (!pids) return 0;
+    d->header->barrier.arrived = 0;
+    d->header->barrier.phase = 0;
+    d->header->failed = 0;
+    d->header->elapsed = 0;
+
+    /* Sin esto cada hijo heredaria una copia de lo pendiente en stdout */
+    fflush(NULL);
+    for (started = 0; started < d->nprocs; started++) {
+        pid_t pid = fork();
+        if (pid == 0) _exit(run_slab(d, cfg, started) ? 0 : 1);
+        if (pid < 0) break;
+        pids[started] = pid;
+    }
+    if (started < d->nprocs) {
+        /* Los que arrancaron esperan en la barrera a los que faltan */
+        kill_running(pids, started);
+        ok = 0;
+    }
+
+    for (running = started; running > 0;) {
+        int status, i;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            ok = 0;
+            break;
+        }
+        for (i = 0; i < started && pids[i] != pid; i++)
+            ;
+        if (i == started) continue;
+        pids[i] = 0;
+        running--;
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            /* Sin ese proceso los demas nunca pasarian la barrera */
+            if (ok) kill_running(pids, started);
+            ok = 0;
+        }
+    }
+    free(pids);
+    return ok;
+}
+
+#else  /* !__linux__ */
+
+struct Domain {
+    int unused;
+};
+
+int domain_supported(void) {
+    return 0;
+}
+
+Domain *domain_create(int width, int height, int nprocs) {
+    (void)width;
+    (void)height;
+    (void)nprocs;
+    return NULL;
+}
+
+void domain_destroy(Domain *d) {
+    free(d);
+}
+
+int domain_procs(const Domain *d) {
+    (void)d;
+    return 0;
+}
+
+unsigned char *domain_grid(Domain *d) {
+    (void)d;
+    return NULL;
+}
+
+int domain_run(Domain *d, const DomainConfig *cfg) {
+    (void)d;
+    (void)cfg;
+    return 0;
+}
+
+double domain_elapsed(const Domain *d) {
+    (void)d;
+    return 0.0;
+}
+
+#endif
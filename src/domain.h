@@ -0,0 +1,98 @@
+/*
+ * domain.h — Un grid repartido entre varios procesos de la misma maquina.
+ *
+ * Para grids que saturan el ancho de banda de memoria de un socket, cada
+ * proceso simula una franja de filas contiguas (su dominio) en su propia
+ * memoria, que el kernel ubica en el nodo NUMA donde corre. Entre
+ * generaciones los procesos solo intercambian las filas de borde:
+ *   1. Cada proceso avanza su franja, con una fila de halo arriba y otra
+ *      abajo (copias de las filas de los vecinos; la primera y la ultima
+ *      franja no tienen halo hacia el borde del grid, que es muerto).
+ *   2. Publica su primera y su ultima fila en memoria compartida POSIX.
+ *   3. Espera en una barrera a que todos hayan publicado.
+ *   4. Copia las filas publicadas por sus vecinos en sus halos.
+ * Las filas publicadas alternan entre dos juegos segun la paridad de la
+ * generacion: un proceso que ya avanzo a la siguiente no pisa las filas
+ * que un vecino mas lento todavia esta leyendo. Con eso alcanza una sola
+ * barrera por generacion.
+ *
+ * La barrera es un contador en la memoria compartida: el ultimo en
+ * llegar avanza la fase y despierta a los demas con un futex; los que
+ * esperan giran un momento antes de dormir. Sin el futex (fuera de
+ * Linux) el modo no esta disponible.
+ *
+ * El grid completo tambien vive en la memoria compartida, un byte por
+ * celda: los procesos leen de ahi su franja inicial y escriben la final,
+ * y el proceso que los lanzo arma el resultado. Como cada celda de una
+ * franja ve los mismos vecinos que en el grid entero, el resultado es
+ * identico al de game_step en un solo proceso.
+ */
+
+#ifndef DOMAIN_H
+#define DOMAIN_H
+
+#include "game.h"
+
+/*
+ * DomainConfig — Como simula cada proceso su franja.
+ *
+ * generations — Generaciones a avanzar.
+ * engine      — Kernel de game_step de cada franja. Los halos son de
+ *               una fila, asi que se avanza de a una generacion: con
+ *               GAME_ENGINE_BLOCKED no hay pasadas de varias.
+ * alloc       — Flags de game_create_ex del Game de cada franja.
+ * threads     — Threads del pool de cada proceso.
+ */
+typedef struct {
+    long generations;
+    GameEngine engine;
+    unsigned alloc;
+    int threads;
+} DomainConfig;
+
+typedef struct Domain Domain;
+
+/*
+ * domain_supported — 1 si el sistema tiene lo necesario (futex).
+ */
+int domain_supported(void);
+
+/*
+ * domain_create — Memoria compartida para un grid de width x height
+ * repartido en nprocs franjas (como maximo una por fila). Retorna NULL
+ * si las dimensiones no son validas o falla la alocacion.
+ */
+Domain *domain_create(int width, int height, int nprocs);
+
+/*
+ * domain_destroy — Libera la memoria compartida. Acepta NULL.
+ */
+void domain_destroy(Domain *d);
+
+/*
+ * domain_procs — Procesos (franjas) efectivos, nprocs acotado al alto.
+ */
+int domain_procs(const Domain *d);
+
+/*
+ * domain_grid — El grid compartido, width * height bytes 0/1 con la
+ * celda (x, y) en [y * width + x]. Se llena antes de domain_run y tiene
+ * el resultado despues.
+ */
+unsigned char *domain_grid(Domain *d);
+
+/*
+ * domain_run — Lanza un proceso por franja con fork, avanza
+ * cfg->generations generaciones y espera a que terminen. Si alguno
+ * falla o muere, los demas se terminan. Retorna 1 en exito y 0 si algun
+ * proceso no pudo crearse o fallo (el grid queda indefinido).
+ */
+int domain_run(Domain *d, const DomainConfig *cfg);
+
+/*
+ * domain_elapsed — Segundos de la ultima domain_run entre la barrera de
+ * arranque y la de cierre: solo los pasos, sin fork ni copias.
+ */
+double domain_elapsed(const Domain *d);
+
+#endif
@@ -0,0 +1,124 @@
+/*
+ * edit.c — Implementacion de la cola de ediciones de edit.h.
+ *
+ * La cola es un arreglo que crece al doble; edit_queue_apply la recorre
+ * en orden y la deja vacia sin liberar la capacidad, asi un arrastre
+ * largo no aloca en cada frame.
+ */
+
+#include <stdlib.h>  /* malloc, realloc, free */
+#include <limits.h>  /* INT_MIN, INT_MAX */
+#include "edit.h"
+
+/* Ediciones iniciales de la cola */
+#define INITIAL_EDITS 64
+
+struct EditQueue {
+    Edit *edits;
+    size_t count, cap;
+};
+
+EditQueue *edit_queue_create(void) {
+    EditQueue *q = malloc(sizeof(EditQueue));
+    if (!q) return NULL;
+    q->edits = NULL;
+    q->count = 0;
+    q->cap = 0;
+    return q;
+}
+
+void edit_queue_destroy(EditQueue *q) {
+    if (!q) return;
+    free(q->edits);
+    free(q);
+}
+
+int edit_queue_push(EditQueue *q, const Edit *e) {
+    if (q->count == q->cap) {
+        size_t cap = q->cap ? q->cap * 2 : INITIAL_EDITS;
+        Edit *edits = realloc(q->edits, cap * sizeof(Edit));
+        if (!edits) return 0;
+        q->edits = edits;
+        q->cap = cap;
+    }
+    q->edits[q->count++] = *e;
+    return 1;
+}
+
+/*
+ * set_cell — Escribe una celda del plano en el Universe o en el grid
+ * (donde las coordenadas fuera de rango se ignoran). Retorna 0 si el
+ * Universe no pudo crear el tile.
+ */
+static int set_cell(Game *g, Universe *u, int64_t x, int64_t y, int alive) {
+    if (u) return universe_set_cell(u, x, y, alive);
+    if (x >= 0 && x < g->width && y >= 0 && y < g->height)
+        game_set_cell(g, (int)x, (int)y, alive);
+    return 1;
+}
+
+/*
+ * apply_segment — Recorre el segmento con Bresenham: cada celda del
+ * camino se escribe una vez, sin huecos entre los extremos.
+ */
+static int apply_segment(Game *g, Universe *u, const Edit *e) {
+    int alive = e->kind == EDIT_PAINT;
+    int64_t x = e->x0, y = e->y0;
+    int64_t dx = e->x1 > e->x0 ? e->x1 - e->x0 : e->x0 - e->x1;
+    int64_t dy = e->y1 > e->y0 ? e->y0 - e->y1 : e->y1 - e->y0;
+    int64_t sx = e->x1 > e->x0 ? 1 : -1, sy = e->y1 > e->y0 ? 1 : -1;
+    int64_t err = dx + dy;
+    for (;;) {
+        int64_t e2 = 2 * err;
+        if (!set_cell(g, u, x, y, alive)) return 0;
+        if (x == e->x1 && y == e->y1) return 1;
+        if (e2 >= dy) { err += dy; x += sx; }
+        if (e2 <= dx) { err += dx; y += sy; }
+    }
+}
+
+/*
+ * stamp_universe — pattern_load solo sabe escribir en un Game: el patron
+ * se arma en un grid del tamanio de su caja y se copian las celdas vivas.
+ */
+static int stamp_universe(Universe *u, const Edit *e) {
+    const PatternInfo *info;
+    int count, i, x, y, w = 0, h = 0, ok = 1;
+    Game *tmp;
+    info = pattern_builtins(&count);
+    for (i = 0; i < count; i++) {
+        if (info[i].type == e->pattern) {
+            w = info[i].width;
+            h = info[i].height;
+            break;
+        }
+    }
+    if (!w || !h) return 1;
+    tmp = game_create(w, h);
+    if (!tmp) return 0;
+    pattern_load(tmp, e->pattern, 0, 0);
+    for (y = 0; y < h && ok; y++)
+        for (x = 0; x < w && ok; x++)
+            if (game_get_cell(tmp, x, y)) ok = universe_set_cell(u, e->x0 + x, e->y0 + y, 1);
+    game_destroy(tmp);
+    return ok;
+}
+
+int edit_queue_apply(EditQueue *q, Game *g, Universe *u) {
+    size_t i;
+    int ok = 1;
+    for (i = 0; i < q->count && ok; i++) {
+        const Edit *e = &q->edits[i];
+        if (e->kind != EDIT_STAMP) {
+            ok = apply_segment(g, u, e);
+        } else if (u) {
+            ok = stamp_universe(u, e);
+        } else if (e->x0 >= INT_MIN / 2 && e->x0 <= INT_MAX / 2 &&
+                   e->y0 >= INT_MIN / 2 && e->y0 <= INT_MAX / 2) {
+            /* pattern_load suma offsets en int: lejos del grid no hay nada que escribir */
+            pattern_load(g, e->pattern, (int)e->x0, (int)e->y0);
+        }
+    }
+    q->count = 0;
+    return ok ? (int)i : -1;
+}
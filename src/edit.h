@@ -0,0 +1,80 @@
+/*
+ * edit.h — Cola de ediciones del visor: pintar, borrar y estampar.
+ *
+ * Los eventos del mouse y del teclado no tocan el grid: encolan
+ * ediciones en coordenadas del plano (en el grid con bordes coinciden
+ * con las del grid; en --unbounded son las del Universe). El loop
+ * principal las aplica todas juntas entre dos generaciones, antes de
+ * avanzar la simulacion, asi un paso nunca ve un grid a medio editar.
+ *
+ * Aplicar una edicion solo actualiza lo que toca:
+ *   - En el Game, game_set_cell y game_write_bits corrigen las
+ *     estadisticas (poblacion y caja) con las celdas del rectangulo
+ *     editado, sin volver a recorrer el grid.
+ *   - En el Universe, universe_set_cell crea el tile si hace falta y lo
+ *     marca con celdas vivas, asi el proximo paso lo expande y calcula.
+ */
+
+#ifndef EDIT_H
+#define EDIT_H
+
+#include <stdint.h>  /* int64_t */
+#include "game.h"
+#include "patterns.h"
+#include "universe.h"
+
+/*
+ * EditKind — Tipo de edicion.
+ *
+ * EDIT_PAINT — Celdas vivas en el segmento (x0, y0) - (x1, y1).
+ * EDIT_ERASE — Celdas muertas en el segmento.
+ * EDIT_STAMP — El patron predefinido con esquina en (x0, y0), combinado
+ *              con OR (no borra lo que ya habia).
+ */
+typedef enum {
+    EDIT_PAINT,
+    EDIT_ERASE,
+    EDIT_STAMP
+} EditKind;
+
+/*
+ * Edit — Una edicion encolada. Un arrastre del mouse se encola como
+ * segmentos entre posiciones consecutivas, para no dejar huecos cuando
+ * el mouse salta varias celdas entre dos eventos.
+ */
+typedef struct {
+    EditKind kind;
+    int64_t x0, y0;
+    int64_t x1, y1;       /* Solo EDIT_PAINT y EDIT_ERASE */
+    PatternType pattern;  /* Solo EDIT_STAMP */
+} Edit;
+
+typedef struct EditQueue EditQueue;
+
+/*
+ * edit_queue_create — Cola vacia. Retorna NULL si falla la alocacion.
+ */
+EditQueue *edit_queue_create(void);
+
+/*
+ * edit_queue_destroy — Libera la cola y las ediciones pendientes.
+ * Acepta NULL.
+ */
+void edit_queue_destroy(EditQueue *q);
+
+/*
+ * edit_queue_push — Encola una copia de e. Retorna 0 si falla la
+ * alocacion (la edicion se pierde).
+ */
+int edit_queue_push(EditQueue *q, const Edit *e);
+
+/*
+ * edit_queue_apply — Aplica las ediciones pendientes en orden y vacia la
+ * cola. Con u distinto de NULL se editan las celdas del Universe (g no
+ * se toca: el llamador copia la ventana despues); si no, las de g.
+ * Retorna la cantidad de ediciones aplicadas, o -1 si el Universe no
+ * pudo crecer (las restantes se descartan).
+ */
+int edit_queue_apply(EditQueue *q, Game *g, Universe *u);
+
+#endif
@@ -8,54 +8,437 @@
  *
  * Complejidad por paso: O(width * height) — se evalua cada celda exactamente
  * una vez, con un conteo de vecinos O(1) constante (siempre 8 adyacentes).
+ *
+ * Todos los indices lineales y tamanios se calculan en size_t a partir de
+ * (size_t)y * width: width * height puede superar INT_MAX aunque cada
+ * dimension quepa en un int.
  */
 
-#include <stdlib.h>  /* malloc, calloc, free, rand, RAND_MAX */
-#include <string.h>  /* memset */
+#define _POSIX_C_SOURCE 200809L  /* mmap, munmap */
+#define _DEFAULT_SOURCE          /* MAP_ANONYMOUS, madvise en glibc */
+#define _DARWIN_C_SOURCE         /* MAP_ANON en macOS */
+
+#include <stdlib.h>    /* malloc, calloc, realloc, free */
+#include <string.h>    /* memset, memcpy, strcmp */
+#include <stdint.h>    /* SIZE_MAX, uintptr_t */
+#include <limits.h>    /* INT_MAX */
+#include <pthread.h>   /* pthread_once */
+#include <sys/mman.h>  /* mmap, munmap, madvise */
 #include "game.h"
+#include "profile.h"
+#include "trace.h"
+#include "rng.h"
+
+/* Algunos sistemas (macOS viejos, BSD) solo definen el nombre corto */
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
 
 /*
- * game_create — Constructor del Game.
+ * Sin reserva de swap: un grid grande casi vacio solo consume las paginas
+ * que se tocan, y el kernel no rechaza el mapeo por superar la memoria
+ * comprometible. Donde no existe, el flag es 0.
+ */
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#define MAP_GRID (MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE)
+
+/* Tamanio de una huge page transparente (x86-64 y arm64 con paginas de 4 KiB) */
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+/* Palabras de 64 celdas por tramo minimo al randomizar en paralelo */
+#define RANDOMIZE_GRAIN 1024
+
+/* Celdas por tramo minimo al repartir las filas de game_step */
+#define STEP_GRAIN_CELLS 16384
+
+/* Nombres de linea de comandos, indexados por GameEngine */
+static const char *const engine_names[GAME_ENGINE_COUNT] = {
+    "scalar", "vector", "blocked", "lut", "colsum"
+};
+
+/*
+ * Tabla de GAME_ENGINE_LUT: resultado 2x2 (4 bits) para cada bloque 4x4
+ * (16 bits). Se genera una vez por proceso, al seleccionar el engine por
+ * primera vez, con conway_rule. pthread_once la protege: dos Game (o dos
+ * GolGrid de libgol) pueden elegir lut a la vez desde threads distintos,
+ * y el segundo espera a que la tabla este completa.
+ */
+static unsigned char lut_table[1 << 16];
+static pthread_once_t lut_once = PTHREAD_ONCE_INIT;
+
+/*
+ * mapped_length — Bytes efectivamente mapeados para un buffer de bytes
+ * bytes: con huge pages se redondea a un multiplo de HUGE_PAGE_SIZE para
+ * que la ultima pagina tambien pueda ser grande. Retorna 0 si desborda.
+ */
+static size_t mapped_length(size_t bytes, unsigned alloc) {
+    if (!(alloc & GAME_ALLOC_HUGEPAGES)) return bytes;
+    if (bytes > SIZE_MAX - HUGE_PAGE_SIZE) return 0;
+    return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+/*
+ * buffer_alloc — Buffer de count elementos de elem bytes, en cero.
  *
- * 1. Aloca la estructura Game con malloc.
- * 2. Calcula el tamanio total del grid (width * height).
- * 3. Aloca ambos buffers con calloc, que inicializa a cero.
- *    calloc(size, sizeof(int)) garantiza que todas las celdas
- *    comienzan muertas sin necesidad de un memset adicional.
- * 4. Si cualquier alocacion falla, libera lo que se haya alocado
- *    y retorna NULL. free(NULL) es seguro segun el estandar C.
+ * Sin flags es un calloc. Con GAME_ALLOC_MMAP es un mapeo anonimo, que el
+ * kernel entrega en cero y respalda con memoria fisica recien al tocar
+ * cada pagina. Con GAME_ALLOC_HUGEPAGES se mapea una huge page de mas,
+ * se recortan la cabeza y la cola para que el buffer quede alineado a
+ * 2 MiB (requisito para que el kernel use paginas grandes) y se pide
+ * MADV_HUGEPAGE. Si madvise no existe o falla, el buffer sigue valido con
+ * paginas normales. Retorna NULL si count * elem desborda o si falla.
+ */
+static void *buffer_alloc(size_t count, size_t elem, unsigned alloc) {
+    size_t len;
+    char *base, *aligned;
+    if (count == 0 || count > SIZE_MAX / elem) return NULL;
+    if (!(alloc & (GAME_ALLOC_MMAP | GAME_ALLOC_HUGEPAGES))) return calloc(count, elem);
+    len = mapped_length(count * elem, alloc);
+    if (len == 0) return NULL;
+    if (!(alloc & GAME_ALLOC_HUGEPAGES)) {
+        base = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_GRID, -1, 0);
+        return base == MAP_FAILED ? NULL : base;
+    }
+    if (len > SIZE_MAX - HUGE_PAGE_SIZE) return NULL;
+    base = mmap(NULL, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_GRID, -1, 0);
+    if (base == MAP_FAILED) return NULL;
+    aligned = (char *)(((uintptr_t)base + HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(HUGE_PAGE_SIZE - 1));
+    if (aligned > base) munmap(base, (size_t)(aligned - base));
+    if (aligned + len < base + len + HUGE_PAGE_SIZE)
+        munmap(aligned + len, (size_t)(base + len + HUGE_PAGE_SIZE - (aligned + len)));
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+    return aligned;
+}
+
+/*
+ * buffer_free — Libera un buffer de buffer_alloc con los mismos
+ * parametros. Acepta NULL.
+ */
+static void buffer_free(void *p, size_t count, size_t elem, unsigned alloc) {
+    if (!p) return;
+    if (!(alloc & (GAME_ALLOC_MMAP | GAME_ALLOC_HUGEPAGES))) {
+        free(p);
+        return;
+    }
+    munmap(p, mapped_length(count * elem, alloc));
+}
+
+/*
+ * game_cell_count — Cantidad de celdas del grid, en size_t.
+ */
+static size_t game_cell_count(const Game *g) {
+    return (size_t)g->width * (size_t)g->height;
+}
+
+/*
+ * game_cell_bytes — Bytes por celda de cells/next: 1 con
+ * GAME_CELLS_BYTES, sizeof(int) si no.
+ */
+static size_t game_cell_bytes(const Game *g) {
+    return (g->alloc & GAME_CELLS_BYTES) ? 1 : sizeof(int);
+}
+
+/*
+ * stats_reset — Deja s vacio: sin celdas y con la caja invertida, para
+ * que cualquier fila con celdas vivas la reemplace al combinarse.
+ */
+static void stats_reset(GameStats *s) {
+    s->population = 0;
+    s->min_x = s->min_y = INT_MAX;
+    s->max_x = s->max_y = -1;
+}
+
+/*
+ * stats_close — Con population 0 no hay caja: los cuatro extremos
+ * quedan en -1, como documenta GameStats.
+ */
+static void stats_close(GameStats *s) {
+    if (!s->population) s->min_x = s->min_y = s->max_x = s->max_y = -1;
+}
+
+/*
+ * stats_merge — Suma la poblacion de src a dst y extiende su caja.
+ */
+static void stats_merge(GameStats *dst, const GameStats *src) {
+    dst->population += src->population;
+    if (src->min_x < dst->min_x) dst->min_x = src->min_x;
+    if (src->min_y < dst->min_y) dst->min_y = src->min_y;
+    if (src->max_x > dst->max_x) dst->max_x = src->max_x;
+    if (src->max_y > dst->max_y) dst->max_y = src->max_y;
+}
+
+/*
+ * stats_add_row — Agrega a s una fila con count celdas vivas, la
+ * primera en la columna first y la ultima en last.
+ */
+static void stats_add_row(GameStats *s, uint64_t count, int first, int last, int y) {
+    s->population += count;
+    if (first < s->min_x) s->min_x = first;
+    if (last > s->max_x) s->max_x = last;
+    if (y < s->min_y) s->min_y = y;
+    if (y > s->max_y) s->max_y = y;
+}
+
+/*
+ * stats_row — Agrega a s las n celdas int de row, que son las columnas
+ * x0..x0+n-1 de la fila y.
+ *
+ * Cuenta sobre palabras empaquetadas (SWAR): cada uint64_t leido son dos
+ * celdas 0/1 en sus mitades, y la suma de palabras acumula ambas mitades
+ * por separado sin que se desborden, con una suma por cada dos celdas.
+ * Los extremos de la caja solo se buscan si la fila tiene alguna celda
+ * viva, y en un grid denso se encuentran enseguida.
+ */
+static void stats_row(GameStats *s, const int *row, int n, int x0, int y) {
+    uint64_t lanes = 0, word, count;
+    int x, first, last;
+    for (x = 0; x + 2 <= n; x += 2) {
+        memcpy(&word, row + x, sizeof(word));
+        lanes += word;
+    }
+    count = (lanes & 0xffffffffu) + (lanes >> 32);
+    if (x < n) count += (unsigned)row[x];
+    if (!count) return;
+    for (first = 0; !row[first]; first++) {}
+    for (last = n - 1; !row[last]; last--) {}
+    stats_add_row(s, count, x0 + first, x0 + last, y);
+}
+
+/*
+ * stats_row8 — stats_row sobre celdas de un byte: cada palabra son 8
+ * celdas, acumuladas en 8 contadores de un byte. Para que ninguno
+ * desborde se vuelcan cada 255 palabras: se suman bytes pares e impares
+ * en 4 contadores de 16 bits, y multiplicar por 0x0001000100010001 deja
+ * la suma de los 4 en los 16 bits altos.
+ */
+static void stats_row8(GameStats *s, const unsigned char *row, int n, int x0, int y) {
+    const uint64_t even = 0x00ff00ff00ff00ffull;
+    uint64_t count = 0, word;
+    int x = 0, first, last;
+    while (x + 8 <= n) {
+        uint64_t lanes = 0;
+        int words = 0;
+        for (; x + 8 <= n && words < 255; x += 8, words++) {
+            memcpy(&word, row + x, sizeof(word));
+            lanes += word;
+        }
+        lanes = (lanes & even) + ((lanes >> 8) & even);
+        count += (lanes * 0x0001000100010001ull) >> 48;
+    }
+    for (; x < n; x++) count += row[x];
+    if (!count) return;
+    for (first = 0; !row[first]; first++) {}
+    for (last = n - 1; !row[last]; last--) {}
+    stats_add_row(s, count, x0 + first, x0 + last, y);
+}
+
+/*
+ * stats_next_row — Agrega a s la fila y del buffer next, recien
+ * calculada y todavia en cache.
+ */
+static void stats_next_row(const Game *g, GameStats *s, int y) {
+    size_t row = (size_t)y * g->width;
+    if (g->next8) stats_row8(s, g->next8 + row, g->width, 0, y);
+    else stats_row(s, g->next + row, g->width, 0, y);
+}
+
+/*
+ * stats_begin — Vacia los parciales de todos los workers antes de un
+ * paso. Cada invocacion de un trabajo acumula en un GameStats local y
+ * lo combina una sola vez en partial[worker].
+ */
+static void stats_begin(Game *g) {
+    int i, n = pool_threads(g->pool);
+    for (i = 0; i < n; i++) stats_reset(&g->partial[i]);
+}
+
+/*
+ * stats_end — Combina los parciales en g->stats. Se llama despues del
+ * swap: stats describe la nueva generacion actual.
+ */
+static void stats_end(Game *g) {
+    int i, n = pool_threads(g->pool);
+    stats_reset(&g->stats);
+    for (i = 0; i < n; i++) stats_merge(&g->stats, &g->partial[i]);
+    stats_close(&g->stats);
+    g->stats_valid = 1;
+}
+
+/*
+ * stats_patch — Corrige g->stats tras reescribir un rectangulo, dadas
+ * las estadisticas del rectangulo antes y despues (sin cerrar). La
+ * poblacion se ajusta por diferencia y la caja se extiende con after.
+ * Si un extremo de la caja estaba dentro del rectangulo y dejo de
+ * estarlo, el nuevo extremo puede estar en cualquier parte del grid:
+ * stats se invalida y game_stats lo recalcula.
+ */
+static void stats_patch(Game *g, const GameStats *before, const GameStats *after) {
+    GameStats *s = &g->stats;
+    if (!g->stats_valid) return;
+    if (before->population &&
+        ((before->min_x == s->min_x && after->min_x > s->min_x) ||
+         (before->max_x == s->max_x && after->max_x < s->max_x) ||
+         (before->min_y == s->min_y && after->min_y > s->min_y) ||
+         (before->max_y == s->max_y && after->max_y < s->max_y))) {
+        g->stats_valid = 0;
+        return;
+    }
+    if (!s->population) {
+        *s = *after;
+    } else {
+        s->population -= before->population;
+        stats_merge(s, after);
+    }
+    if (!s->population) stats_reset(s);
+    stats_close(s);
+}
+
+/*
+ * swap_buffers — Intercambia la generacion actual y la siguiente. Solo
+ * uno de los pares (cells/next o cells8/next8) existe; el otro son dos
+ * NULL y el swap no los altera.
+ */
+static void swap_buffers(Game *g) {
+    int *tmp = g->cells;
+    unsigned char *tmp8 = g->cells8;
+    g->cells = g->next;
+    g->next = tmp;
+    g->cells8 = g->next8;
+    g->next8 = tmp8;
+}
+
+/*
+ * game_create — Constructor del Game con alocacion por defecto (calloc).
  */
 Game *game_create(int width, int height) {
-    Game *g = malloc(sizeof(Game));
+    return game_create_ex(width, height, 0);
+}
+
+/*
+ * game_create_ex — Constructor del Game.
+ *
+ * 1. Valida las dimensiones: ambas positivas. El producto se calcula en
+ *    size_t y buffer_alloc verifica que size * bytes por celda no
+ *    desborde.
+ * 2. Aloca la estructura Game con malloc.
+ * 3. Aloca ambos buffers (de int, o de bytes con GAME_CELLS_BYTES) con
+ *    buffer_alloc, que los entrega en cero: todas las celdas comienzan
+ *    muertas sin un memset adicional.
+ * 4. Si cualquier alocacion falla, libera lo que se haya alocado con
+ *    game_destroy y retorna NULL. buffer_free(NULL) es seguro, como
+ *    free(NULL).
+ */
+Game *game_create_ex(int width, int height, unsigned alloc) {
+    Game *g;
+    size_t size;
+    if (width <= 0 || height <= 0) return NULL;
+    g = malloc(sizeof(Game));
     if (!g) return NULL;
     g->width = width;
     g->height = height;
-    int size = width * height;
-    g->cells = calloc(size, sizeof(int));
-    g->next = calloc(size, sizeof(int));
-    if (!g->cells || !g->next) {
-        free(g->cells);
-        free(g->next);
-        free(g);
+    g->track = GAME_TRACK_NONE;
+    g->heat = NULL;
+    g->pool = NULL;
+    g->engine = GAME_ENGINE_VECTOR;
+    g->time_block = GAME_TIME_BLOCK_DEFAULT;
+    g->alloc = alloc;
+    size = game_cell_count(g);
+    g->cells = g->next = NULL;
+    g->cells8 = g->next8 = NULL;
+    stats_reset(&g->stats);
+    stats_close(&g->stats);
+    g->stats_valid = 1;
+    g->partial = malloc(sizeof(GameStats));
+    if (!g->partial) {
+        game_destroy(g);
         return NULL;
     }
-    return g;
+    if (alloc & GAME_CELLS_BYTES) {
+        g->cells8 = buffer_alloc(size, 1, alloc);
+        g->next8 = buffer_alloc(size, 1, alloc);
+        if (g->cells8 && g->next8) return g;
+    } else {
+        g->cells = buffer_alloc(size, sizeof(int), alloc);
+        g->next = buffer_alloc(size, sizeof(int), alloc);
+        if (g->cells && g->next) return g;
+    }
+    game_destroy(g);
+    return NULL;
 }
 
 /*
  * game_destroy — Destructor del Game.
  *
- * Libera los dos buffers dinamicos y la estructura misma.
- * La verificacion de NULL al inicio permite llamar game_destroy(NULL)
- * sin riesgo, siguiendo la convencion de free().
+ * Libera los buffers dinamicos (de la misma forma en que se alocaron)
+ * y la estructura misma. La verificacion de NULL al inicio permite
+ * llamar game_destroy(NULL) sin riesgo, siguiendo la convencion de free().
  */
 void game_destroy(Game *g) {
+    size_t size;
     if (!g) return;
-    free(g->cells);
-    free(g->next);
+    size = game_cell_count(g);
+    buffer_free(g->cells, size, sizeof(int), g->alloc);
+    buffer_free(g->next, size, sizeof(int), g->alloc);
+    buffer_free(g->cells8, size, 1, g->alloc);
+    buffer_free(g->next8, size, 1, g->alloc);
+    buffer_free(g->heat, size, 1, g->alloc);
+    pool_destroy(g->pool);
+    free(g->partial);
     free(g);
 }
 
+/*
+ * game_set_threads — Reemplaza el pool actual por uno de nthreads.
+ * Con nthreads <= 1 no se crea pool: las operaciones corren en linea.
+ * Los parciales de GameStats se redimensionan al nuevo pool; si no
+ * pueden alocarse, el Game vuelve a un solo thread (el parcial existente
+ * alcanza para uno).
+ */
+int game_set_threads(Game *g, int nthreads) {
+    GameStats *partial;
+    pool_destroy(g->pool);
+    g->pool = NULL;
+    if (nthreads <= 1) return 1;
+    g->pool = pool_create(nthreads);
+    if (!g->pool) return 0;
+    partial = realloc(g->partial, sizeof(GameStats) * (size_t)pool_threads(g->pool));
+    if (!partial) {
+        pool_destroy(g->pool);
+        g->pool = NULL;
+        return 0;
+    }
+    g->partial = partial;
+    return 1;
+}
+
+/*
+ * game_set_tracking — Gestiona el ciclo de vida del buffer heat.
+ *
+ * GAME_TRACK_NONE libera el buffer, con lo que game_step vuelve a no
+ * tener ningun costo adicional. Cualquier otro modo reutiliza el buffer
+ * existente o lo aloca en cero, con los mismos flags que el grid. Al
+ * cambiar de modo los contadores se reinician, ya que edad y actividad
+ * no son comparables entre si.
+ */
+int game_set_tracking(Game *g, GameTrack mode) {
+    size_t size = game_cell_count(g);
+    if (mode == GAME_TRACK_NONE) {
+        buffer_free(g->heat, size, 1, g->alloc);
+        g->heat = NULL;
+    } else if (!g->heat) {
+        g->heat = buffer_alloc(size, 1, g->alloc);
+        if (!g->heat) return 0;
+    } else if (mode != g->track) {
+        memset(g->heat, 0, size);
+    }
+    g->track = mode;
+    return 1;
+}
+
 /*
  * game_get_cell — Lectura segura de una celda.
  *
@@ -65,12 +448,14 @@ void game_destroy(Game *g) {
  *   2. Implementa bordes muertos: las celdas virtuales mas alla del
  *      borde siempre estan muertas, lo que simplifica count_neighbors.
  *
- * El mapeo 2D->1D usa row-major order: indice = y * width + x.
+ * El mapeo 2D->1D usa row-major order: indice = y * width + x,
+ * calculado en size_t para grids de mas de 2^31 celdas.
  */
 int game_get_cell(Game *g, int x, int y) {
     if (x < 0 || x >= g->width || y < 0 || y >= g->height)
         return 0;
-    return g->cells[y * g->width + x];
+    if (g->cells8) return g->cells8[(size_t)y * g->width + x];
+    return g->cells[(size_t)y * g->width + x];
 }
 
 /*
@@ -81,9 +466,216 @@ int game_get_cell(Game *g, int x, int y) {
  * Las coordenadas fuera de rango se ignoran sin error.
  */
 void game_set_cell(Game *g, int x, int y, int alive) {
+    size_t at;
+    int was;
     if (x < 0 || x >= g->width || y < 0 || y >= g->height)
         return;
-    g->cells[y * g->width + x] = alive ? 1 : 0;
+    at = (size_t)y * g->width + x;
+    alive = alive ? 1 : 0;
+    was = g->cells8 ? g->cells8[at] : g->cells[at];
+    if (was == alive) return;
+    if (g->cells8) g->cells8[at] = (unsigned char)alive;
+    else g->cells[at] = alive;
+    if (g->stats_valid) {
+        GameStats before, after;
+        stats_reset(&before);
+        stats_reset(&after);
+        if (was) stats_add_row(&before, 1, x, x, y);
+        else stats_add_row(&after, 1, x, x, y);
+        stats_patch(g, &before, &after);
+    }
+}
+
+/* Columnas por tramo al convertir bitmaps (buffer en el stack) */
+#define REGION_CHUNK 512
+
+/*
+ * Una escritura de hasta 1/REGION_PATCH_RATIO del grid corrige stats con
+ * las celdas del rectangulo; una mayor lo invalida, porque medir el
+ * rectangulo antes y despues costaria mas que recontar el grid.
+ */
+#define REGION_PATCH_RATIO 8
+
+/*
+ * region_stats — GameStats (sin cerrar) del rectangulo [c0, c1) x
+ * [r0, r1), ya recortado al grid.
+ */
+static void region_stats(const Game *g, int c0, int c1, int r0, int r1, GameStats *s) {
+    int r;
+    stats_reset(s);
+    for (r = r0; r < r1; r++) {
+        size_t at = (size_t)r * g->width + (size_t)c0;
+        if (g->cells8) stats_row8(s, g->cells8 + at, c1 - c0, c0, r);
+        else stats_row(s, g->cells + at, c1 - c0, c0, r);
+    }
+}
+
+/*
+ * patch_worthwhile — 1 si conviene corregir stats tras escribir el
+ * rectangulo en lugar de invalidarlo.
+ */
+static int patch_worthwhile(const Game *g, int c0, int c1, int r0, int r1) {
+    return g->stats_valid &&
+           (size_t)(c1 - c0) * (size_t)(r1 - r0) <= game_cell_count(g) / REGION_PATCH_RATIO;
+}
+
+/*
+ * clip_region — Interseccion del rectangulo con el grid, en columnas y
+ * filas relativas al rectangulo: [*c0, *c1) x [*r0, *r1). Retorna 0 si
+ * es vacia (y deja los cuatro limites en 0). Calcula en long long para
+ * que x + w no desborde.
+ */
+static int clip_region(const Game *g, int x, int y, int w, int h,
+                       int *c0, int *c1, int *r0, int *r1) {
+    long long x0 = x < 0 ? -(long long)x : 0, y0 = y < 0 ? -(long long)y : 0;
+    long long x1 = w, y1 = h;
+    if (x1 > (long long)g->width - x) x1 = (long long)g->width - x;
+    if (y1 > (long long)g->height - y) y1 = (long long)g->height - y;
+    if (x0 >= x1 || y0 >= y1) {
+        *c0 = *c1 = *r0 = *r1 = 0;
+        return 0;
+    }
+    *c0 = (int)x0;
+    *c1 = (int)x1;
+    *r0 = (int)y0;
+    *r1 = (int)y1;
+    return 1;
+}
+
+/*
+ * read_row — Copia n celdas desde (x, y), ya dentro del grid, como bytes
+ * 0/1: memcpy con celdas de un byte, conversion con celdas int.
+ */
+static void read_row(const Game *g, int x, int y, size_t n, unsigned char *dst) {
+    size_t at = (size_t)y * g->width + (size_t)x, i;
+    if (g->cells8) {
+        memcpy(dst, g->cells8 + at, n);
+    } else {
+        const int *row = g->cells + at;
+        for (i = 0; i < n; i++) dst[i] = (unsigned char)row[i];
+    }
+}
+
+/*
+ * write_row — Combina n bytes 0/1 de src con las celdas desde (x, y).
+ * Con celdas de un byte, COPY es un memcpy y los demas modos operan de
+ * a 8 celdas por palabra de 64 bits (con valores 0/1 el resultado sigue
+ * siendo 0/1 en cada byte).
+ */
+static void write_row(Game *g, int x, int y, size_t n, const unsigned char *src, GameBlend blend) {
+    size_t at = (size_t)y * g->width + (size_t)x, i = 0;
+    if (g->cells8) {
+        unsigned char *row = g->cells8 + at;
+        uint64_t a, b;
+        if (blend == GAME_BLEND_COPY) {
+            memcpy(row, src, n);
+            return;
+        }
+        for (; i + 8 <= n; i += 8) {
+            memcpy(&a, row + i, 8);
+            memcpy(&b, src + i, 8);
+            if (blend == GAME_BLEND_OR) a |= b;
+            else if (blend == GAME_BLEND_XOR) a ^= b;
+            else a &= b;
+            memcpy(row + i, &a, 8);
+        }
+        for (; i < n; i++) {
+            if (blend == GAME_BLEND_OR) row[i] |= src[i];
+            else if (blend == GAME_BLEND_XOR) row[i] ^= src[i];
+            else row[i] &= src[i];
+        }
+    } else {
+        int *row = g->cells + at;
+        switch (blend) {
+            case GAME_BLEND_COPY: for (; i < n; i++) row[i] = src[i]; break;
+            case GAME_BLEND_OR:   for (; i < n; i++) row[i] |= src[i]; break;
+            case GAME_BLEND_XOR:  for (; i < n; i++) row[i] ^= src[i]; break;
+            case GAME_BLEND_AND:  for (; i < n; i++) row[i] &= src[i]; break;
+        }
+    }
+}
+
+void game_read_region(const Game *g, int x, int y, int w, int h,
+                      unsigned char *dst, size_t stride) {
+    int c0, c1, r0, r1, r;
+    clip_region(g, x, y, w, h, &c0, &c1, &r0, &r1);
+    if (w <= 0) return;
+    for (r = 0; r < h; r++) {
+        unsigned char *out = dst + (size_t)r * stride;
+        if (r < r0 || r >= r1) {
+            memset(out, 0, (size_t)w);
+            continue;
+        }
+        memset(out, 0, (size_t)c0);
+        read_row(g, x + c0, y + r, (size_t)(c1 - c0), out + c0);
+        memset(out + c1, 0, (size_t)(w - c1));
+    }
+}
+
+void game_write_region(Game *g, int x, int y, int w, int h,
+                       const unsigned char *src, size_t stride, GameBlend blend) {
+    GameStats before, after;
+    int c0, c1, r0, r1, r, patch;
+    if (!clip_region(g, x, y, w, h, &c0, &c1, &r0, &r1)) return;
+    patch = patch_worthwhile(g, x + c0, x + c1, y + r0, y + r1);
+    if (patch) region_stats(g, x + c0, x + c1, y + r0, y + r1, &before);
+    else g->stats_valid = 0;
+    for (r = r0; r < r1; r++)
+        write_row(g, x + c0, y + r, (size_t)(c1 - c0), src + (size_t)r * stride + c0, blend);
+    if (patch) {
+        region_stats(g, x + c0, x + c1, y + r0, y + r1, &after);
+        stats_patch(g, &before, &after);
+    }
+}
+
+/*
+ * game_read_bits — Cada tramo de hasta REGION_CHUNK columnas se lee con
+ * read_row a un buffer de bytes y se empaqueta de a 8 celdas por byte.
+ */
+void game_read_bits(const Game *g, int x, int y, int w, int h,
+                    unsigned char *dst, size_t stride) {
+    unsigned char tmp[REGION_CHUNK];
+    int c0, c1, r0, r1, r, c, i, n;
+    clip_region(g, x, y, w, h, &c0, &c1, &r0, &r1);
+    if (w <= 0) return;
+    for (r = 0; r < h; r++) {
+        unsigned char *out = dst + (size_t)r * stride;
+        memset(out, 0, ((size_t)w + 7) / 8);
+        if (r < r0 || r >= r1) continue;
+        for (c = c0; c < c1; c += n) {
+            n = c1 - c < REGION_CHUNK ? c1 - c : REGION_CHUNK;
+            read_row(g, x + c, y + r, (size_t)n, tmp);
+            for (i = 0; i < n; i++)
+                out[(c + i) >> 3] |= (unsigned char)(tmp[i] << ((c + i) & 7));
+        }
+    }
+}
+
+/*
+ * game_write_bits — Desempaqueta cada tramo a bytes 0/1 en el stack y
+ * lo combina con write_row.
+ */
+void game_write_bits(Game *g, int x, int y, int w, int h,
+                     const unsigned char *src, size_t stride, GameBlend blend) {
+    unsigned char tmp[REGION_CHUNK];
+    GameStats before, after;
+    int c0, c1, r0, r1, r, c, i, n, patch;
+    if (!clip_region(g, x, y, w, h, &c0, &c1, &r0, &r1)) return;
+    patch = patch_worthwhile(g, x + c0, x + c1, y + r0, y + r1);
+    if (patch) region_stats(g, x + c0, x + c1, y + r0, y + r1, &before);
+    else g->stats_valid = 0;
+    for (r = r0; r < r1; r++) {
+        const unsigned char *in = src + (size_t)r * stride;
+        for (c = c0; c < c1; c += n) {
+            n = c1 - c < REGION_CHUNK ? c1 - c : REGION_CHUNK;
+            for (i = 0; i < n; i++) tmp[i] = (in[(c + i) >> 3] >> ((c + i) & 7)) & 1u;
+            write_row(g, x + c, y + r, (size_t)n, tmp, blend);
+        }
+    }
+    if (patch) {
+        region_stats(g, x + c0, x + c1, y + r0, y + r1, &after);
+        stats_patch(g, &before, &after);
+    }
 }
 
 /*
@@ -111,70 +703,750 @@ static int count_neighbors(Game *g, int x, int y) {
 }
 
 /*
- * game_step — Avanza una generacion aplicando las reglas de Conway.
+ * heat_update — Nuevo valor del contador heat de una celda.
+ *
+ * Modo edad: si la celda queda viva, su edad crece en 1 saturando en 255;
+ * si queda muerta, vuelve a 0.
+ * Modo actividad: un cambio de estado (nacimiento o muerte) suma
+ * GAME_ACTIVITY_BUMP saturando en 255; sin cambio, el valor decae en
+ * h/8 + 1 hasta llegar a 0, lo que produce un rastro que se desvanece
+ * en unas pocas decenas de generaciones.
+ */
+static unsigned char heat_update(GameTrack track, unsigned char h,
+                                 int was_alive, int alive) {
+    if (track == GAME_TRACK_AGE)
+        return alive ? (unsigned char)(h < 255 ? h + 1 : 255) : 0;
+    if (was_alive != alive)
+        return (unsigned char)(h > 255 - GAME_ACTIVITY_BUMP ? 255 : h + GAME_ACTIVITY_BUMP);
+    return h ? (unsigned char)(h - (h >> 3) - 1) : 0;
+}
+
+/*
+ * step_row_scalar — Calcula la fila y de next con el kernel de referencia.
  *
- * Recorre todas las celdas del grid en order row-major. Para cada celda:
+ * Para cada celda:
  *   - Cuenta sus vecinos vivos con count_neighbors.
  *   - Aplica las 4 reglas de Conway (condensadas en 2 condiciones):
  *       * Celda viva: sobrevive si tiene exactamente 2 o 3 vecinos.
  *       * Celda muerta: nace si tiene exactamente 3 vecinos.
- *   - Escribe el resultado en el buffer next.
+ *   - Escribe el resultado en el buffer next (o next8).
+ */
+static void step_row_scalar(Game *g, int y) {
+    size_t row = (size_t)y * g->width;
+    int x;
+    for (x = 0; x < g->width; x++) {
+        int n = count_neighbors(g, x, y);
+        int alive;
+        if (game_get_cell(g, x, y)) {
+            /* Reglas 1-3: viva con 2 o 3 vecinos sobrevive, si no muere */
+            alive = (n == 2 || n == 3) ? 1 : 0;
+        } else {
+            /* Regla 4: muerta con exactamente 3 vecinos nace */
+            alive = (n == 3) ? 1 : 0;
+        }
+        if (g->next8) g->next8[row + x] = (unsigned char)alive;
+        else g->next[row + x] = alive;
+    }
+}
+
+/*
+ * step_row_vector — Calcula una fila interior (0 < y < height - 1).
+ *
+ * Las filas de arriba y abajo existen, asi que las columnas interiores
+ * suman sus 8 vecinos directamente desde tres punteros de fila, sin
+ * verificar limites. Las reglas se expresan como operaciones logicas
+ * ((n == 3) | (viva & n == 2)), sin branches: el loop es una secuencia
+ * de sumas y comparaciones sobre enteros contiguos que el compilador
+ * vectoriza. Las columnas 0 y width - 1 usan count_neighbors.
+ */
+static void step_row_vector(Game *g, int y) {
+    const int w = g->width;
+    const int *up = g->cells + (size_t)(y - 1) * w;
+    const int *mid = g->cells + (size_t)y * w;
+    const int *down = g->cells + (size_t)(y + 1) * w;
+    int *out = g->next + (size_t)y * w;
+    int x, n;
+    for (x = 1; x < w - 1; x++) {
+        n = up[x - 1] + up[x] + up[x + 1] +
+                mid[x - 1] + mid[x + 1] +
+                down[x - 1] + down[x] + down[x + 1];
+        out[x] = (n == 3) | (mid[x] & (n == 2));
+    }
+    n = count_neighbors(g, 0, y);
+    out[0] = (n == 3) | (mid[0] & (n == 2));
+    if (w > 1) {
+        n = count_neighbors(g, w - 1, y);
+        out[w - 1] = (n == 3) | (mid[w - 1] & (n == 2));
+    }
+}
+
+/*
+ * step_row_vector8 — step_row_vector sobre GAME_CELLS_BYTES. La suma de
+ * 8 vecinos entra en un byte, asi que el loop procesa 4 veces mas
+ * celdas por registro vectorial que la version de int.
+ */
+static void step_row_vector8(Game *g, int y) {
+    const int w = g->width;
+    const unsigned char *up = g->cells8 + (size_t)(y - 1) * w;
+    const unsigned char *mid = g->cells8 + (size_t)y * w;
+    const unsigned char *down = g->cells8 + (size_t)(y + 1) * w;
+    unsigned char *out = g->next8 + (size_t)y * w;
+    int x;
+    unsigned char n;
+    for (x = 1; x < w - 1; x++) {
+        n = (unsigned char)(up[x - 1] + up[x] + up[x + 1] +
+                            mid[x - 1] + mid[x + 1] +
+                            down[x - 1] + down[x] + down[x + 1]);
+        out[x] = (unsigned char)((n == 3) | (mid[x] & (n == 2)));
+    }
+    n = (unsigned char)count_neighbors(g, 0, y);
+    out[0] = (unsigned char)((n == 3) | (mid[0] & (n == 2)));
+    if (w > 1) {
+        n = (unsigned char)count_neighbors(g, w - 1, y);
+        out[w - 1] = (unsigned char)((n == 3) | (mid[w - 1] & (n == 2)));
+    }
+}
+
+/*
+ * update_heat_row — Actualiza el heat de la fila y comparando cells
+ * (generacion anterior) con next (la recien calculada).
+ */
+static void update_heat_row(Game *g, int y) {
+    size_t row = (size_t)y * g->width;
+    unsigned char *hrow = g->heat + row;
+    int x;
+    if (g->cells8) {
+        const unsigned char *was = g->cells8 + row, *now = g->next8 + row;
+        for (x = 0; x < g->width; x++)
+            hrow[x] = heat_update(g->track, hrow[x], was[x], now[x]);
+    } else {
+        const int *was = g->cells + row, *now = g->next + row;
+        for (x = 0; x < g->width; x++)
+            hrow[x] = heat_update(g->track, hrow[x], was[x], now[x]);
+    }
+}
+
+/*
+ * step_rows — Trabajo paralelo de game_step: calcula las filas
+ * [begin, end) de next y, si el tracking esta activo, actualiza el heat
+ * de esas filas. Cada fila de next solo la escribe un thread y cells es
+ * de solo lectura durante el paso, asi que no hace falta sincronizacion.
+ *
+ * El heat y los GameStats se actualizan fila por fila justo despues de
+ * calcularla, con cells y next todavia en cache.
+ */
+static void step_rows(void *ctx, size_t begin, size_t end, int worker) {
+    Game *g = ctx;
+    GameStats acc;
+    int y;
+    stats_reset(&acc);
+    for (y = (int)begin; y < (int)end; y++) {
+        if (g->engine != GAME_ENGINE_SCALAR && y > 0 && y < g->height - 1) {
+            if (g->cells8) step_row_vector8(g, y);
+            else step_row_vector(g, y);
+        } else
+            step_row_scalar(g, y);
+        if (g->heat) update_heat_row(g, y);
+        stats_next_row(g, &acc, y);
+    }
+    stats_merge(&g->partial[worker], &acc);
+}
+
+/*
+ * conway_rule — Estado siguiente de una celda con n vecinos vivos. Es la
+ * regla de la que se genera la tabla de GAME_ENGINE_LUT.
+ */
+static int conway_rule(int alive, int n) {
+    return alive ? (n == 2 || n == 3) : (n == 3);
+}
+
+/*
+ * build_lut — Genera lut_table a partir de conway_rule (una sola vez,
+ * via pthread_once desde game_set_engine).
+ *
+ * El indice codifica un bloque de 4x4 celdas por columnas: los bits
+ * 4c..4c+3 son la columna c (bit 4c + r = fila r). Asi, al avanzar dos
+ * columnas, el indice siguiente se obtiene desplazando 8 bits y
+ * agregando dos columnas nuevas. El resultado son las 4 celdas
+ * centrales (columnas y filas 1 y 2): bit 0 = (1, 1), bit 1 = (2, 1),
+ * bit 2 = (1, 2), bit 3 = (2, 2).
+ */
+static void build_lut(void) {
+    unsigned idx;
+    int out, dx, dy;
+    for (idx = 0; idx < (1u << 16); idx++) {
+        unsigned char res = 0;
+        for (out = 0; out < 4; out++) {
+            int cx = 1 + (out & 1), cy = 1 + (out >> 1), n = 0;
+            for (dy = -1; dy <= 1; dy++)
+                for (dx = -1; dx <= 1; dx++)
+                    if (dx || dy) n += (idx >> ((cx + dx) * 4 + cy + dy)) & 1u;
+            if (conway_rule((idx >> (cx * 4 + cy)) & 1u, n)) res |= (unsigned char)(1u << out);
+        }
+        lut_table[idx] = res;
+    }
+}
+
+/*
+ * LUT_COLUMN — Nibble vertical de la columna cx de rows (0 fuera del
+ * grid), la entrada de 4 bits que aporta cada columna al indice.
+ */
+#define LUT_COLUMN(cx) ((cx) < 0 || (cx) >= w ? 0u :                       \
+        (unsigned)((rows[0] ? rows[0][cx] : 0) | (rows[1][cx] << 1) |       \
+                   ((rows[2] ? rows[2][cx] : 0) << 2) |                      \
+                   ((rows[3] ? rows[3][cx] : 0) << 3)))
+
+/*
+ * LUT_PAIRS — Cuerpo de step_pairs_lut para celdas de tipo cell en los
+ * buffers src y dst (cells/next o cells8/next8), con stats_fn como
+ * acumulador de estadisticas de fila.
+ */
+#define LUT_PAIRS(cell, src, dst, stats_fn)                                 \
+    do {                                                                    \
+        int y = (int)p * 2, r, x;                                           \
+        const cell *rows[4];                                                \
+        cell *out0 = g->dst + (size_t)y * w;                                \
+        cell *out1 = y + 1 < h ? out0 + w : NULL;                           \
+        unsigned idx = 0;                                                   \
+        for (r = 0; r < 4; r++) {                                           \
+            int ry = y - 1 + r;                                             \
+            rows[r] = ry >= 0 && ry < h ? g->src + (size_t)ry * w : NULL;   \
+        }                                                                   \
+        idx = LUT_COLUMN(0) << 4 | LUT_COLUMN(1) << 8 | LUT_COLUMN(2) << 12; \
+        for (x = 0; x < w; x += 2) {                                        \
+            unsigned res = lut_table[idx];                                  \
+            out0[x] = (cell)(res & 1u);                                     \
+            if (x + 1 < w) out0[x + 1] = (cell)((res >> 1) & 1u);           \
+            if (out1) {                                                     \
+                out1[x] = (cell)((res >> 2) & 1u);                          \
+                if (x + 1 < w) out1[x + 1] = (cell)(res >> 3);              \
+            }                                                               \
+            idx = idx >> 8 | LUT_COLUMN(x + 3) << 8 | LUT_COLUMN(x + 4) << 12; \
+        }                                                                   \
+        if (g->heat) {                                                      \
+            update_heat_row(g, y);                                          \
+            if (out1) update_heat_row(g, y + 1);                            \
+        }                                                                   \
+        stats_fn(&acc, out0, w, 0, y);                                      \
+        if (out1) stats_fn(&acc, out1, w, 0, y + 1);                        \
+    } while (0)
+
+/*
+ * step_pairs_lut — Trabajo paralelo de GAME_ENGINE_LUT: calcula los
+ * pares de filas [begin, end), es decir las filas 2p y 2p + 1.
+ *
+ * Para cada par se toman las filas y - 1 .. y + 2 (NULL si caen fuera
+ * del grid: bordes muertos). Cada columna aporta un nibble vertical de
+ * 4 bits; el bloque de la salida (x, x + 1) usa las columnas x - 1 ..
+ * x + 2, y pasar al bloque siguiente cuesta leer dos columnas nuevas
+ * (8 celdas para 4 resultados, en lugar de 9 lecturas por celda). Una
+ * sola busqueda en lut_table produce las 4 celdas. El mismo cuerpo
+ * (LUT_PAIRS) se expande para celdas int y para GAME_CELLS_BYTES.
+ */
+static void step_pairs_lut(void *ctx, size_t begin, size_t end, int worker) {
+    Game *g = ctx;
+    const int w = g->width, h = g->height;
+    GameStats acc;
+    size_t p;
+    stats_reset(&acc);
+    for (p = begin; p < end; p++) {
+        if (g->cells8) LUT_PAIRS(unsigned char, cells8, next8, stats_row8);
+        else LUT_PAIRS(int, cells, next, stats_row);
+    }
+    stats_merge(&g->partial[worker], &acc);
+}
+
+#undef LUT_PAIRS
+#undef LUT_COLUMN
+
+/*
+ * ColsumJob — Estado de un paso de GAME_ENGINE_COLSUM. Cada worker usa
+ * su propio tramo de sums (stride bytes): width + 2 sumas de columna,
+ * con una columna muerta a cada lado, del mismo tipo que las celdas.
+ */
+typedef struct {
+    Game *g;
+    unsigned char *sums;
+    size_t stride;
+} ColsumJob;
+
+/*
+ * step_rows_colsum — Trabajo paralelo de GAME_ENGINE_COLSUM: calcula las
+ * filas [begin, end) manteniendo, para cada columna x, la suma vertical
+ * de las filas y - 1, y, y + 1 en sums[x + 1].
+ *
+ * Las sumas se inicializan una vez por tramo; al bajar una fila, cada
+ * columna se actualiza sumando la celda que entra (fila y + 2) y
+ * restando la que sale (fila y - 1). La suma de los 9 del bloque 3x3 es
+ * entonces sums[x] + sums[x + 1] + sums[x + 2], y con la celda incluida
+ * las reglas quedan (t == 3) | (viva & t == 4). Cada celda nueva cuesta
+ * dos lecturas del grid en lugar de nueve.
+ */
+static void step_rows_colsum(void *ctx, size_t begin, size_t end, int worker) {
+    ColsumJob *job = ctx;
+    Game *g = job->g;
+    const int w = g->width, h = g->height;
+    int *sums = (int *)(job->sums + (size_t)worker * job->stride);
+    int y = (int)begin, x;
+    GameStats acc;
+    stats_reset(&acc);
+
+    sums[0] = sums[w + 1] = 0;
+    for (x = 0; x < w; x++) sums[x + 1] = g->cells[(size_t)y * w + x];
+    if (y > 0)
+        for (x = 0; x < w; x++) sums[x + 1] += g->cells[(size_t)(y - 1) * w + x];
+    if (y < h - 1)
+        for (x = 0; x < w; x++) sums[x + 1] += g->cells[(size_t)(y + 1) * w + x];
+
+    for (;;) {
+        const int *mid = g->cells + (size_t)y * w;
+        int *out = g->next + (size_t)y * w;
+        for (x = 0; x < w; x++) {
+            int t = sums[x] + sums[x + 1] + sums[x + 2];
+            out[x] = (t == 3) | (mid[x] & (t == 4));
+        }
+        if (g->heat) update_heat_row(g, y);
+        stats_row(&acc, out, w, 0, y);
+        if (++y >= (int)end) break;
+        /* Desplaza la ventana: entra la fila y + 1, sale la fila y - 2 */
+        if (y < h - 1 && y > 1) {
+            const int *in = g->cells + (size_t)(y + 1) * w;
+            const int *old = g->cells + (size_t)(y - 2) * w;
+            for (x = 0; x < w; x++) sums[x + 1] += in[x] - old[x];
+        } else if (y < h - 1) {
+            const int *in = g->cells + (size_t)(y + 1) * w;
+            for (x = 0; x < w; x++) sums[x + 1] += in[x];
+        } else if (y > 1) {
+            const int *old = g->cells + (size_t)(y - 2) * w;
+            for (x = 0; x < w; x++) sums[x + 1] -= old[x];
+        }
+    }
+    stats_merge(&g->partial[worker], &acc);
+}
+
+/*
+ * step_rows_colsum8 — step_rows_colsum sobre GAME_CELLS_BYTES. Las sumas
+ * son bytes (una columna suma como maximo 3 y el bloque 9), asi que cada
+ * loop procesa 16 o 32 celdas por registro vectorial. La resta de la
+ * fila que sale puede pasar por valores negativos transitorios: en
+ * aritmetica modulo 256 el resultado final es el mismo.
+ */
+static void step_rows_colsum8(void *ctx, size_t begin, size_t end, int worker) {
+    ColsumJob *job = ctx;
+    Game *g = job->g;
+    const int w = g->width, h = g->height;
+    unsigned char *sums = job->sums + (size_t)worker * job->stride;
+    int y = (int)begin, x;
+    GameStats acc;
+    stats_reset(&acc);
+
+    sums[0] = sums[w + 1] = 0;
+    memcpy(sums + 1, g->cells8 + (size_t)y * w, (size_t)w);
+    if (y > 0)
+        for (x = 0; x < w; x++) sums[x + 1] += g->cells8[(size_t)(y - 1) * w + x];
+    if (y < h - 1)
+        for (x = 0; x < w; x++) sums[x + 1] += g->cells8[(size_t)(y + 1) * w + x];
+
+    for (;;) {
+        const unsigned char *mid = g->cells8 + (size_t)y * w;
+        unsigned char *out = g->next8 + (size_t)y * w;
+        for (x = 0; x < w; x++) {
+            unsigned char t = (unsigned char)(sums[x] + sums[x + 1] + sums[x + 2]);
+            out[x] = (unsigned char)((t == 3) | (mid[x] & (t == 4)));
+        }
+        if (g->heat) update_heat_row(g, y);
+        stats_row8(&acc, out, w, 0, y);
+        if (++y >= (int)end) break;
+        if (y < h - 1 && y > 1) {
+            const unsigned char *in = g->cells8 + (size_t)(y + 1) * w;
+            const unsigned char *old = g->cells8 + (size_t)(y - 2) * w;
+            for (x = 0; x < w; x++) sums[x + 1] = (unsigned char)(sums[x + 1] + in[x] - old[x]);
+        } else if (y < h - 1) {
+            const unsigned char *in = g->cells8 + (size_t)(y + 1) * w;
+            for (x = 0; x < w; x++) sums[x + 1] += in[x];
+        } else if (y > 1) {
+            const unsigned char *old = g->cells8 + (size_t)(y - 2) * w;
+            for (x = 0; x < w; x++) sums[x + 1] -= old[x];
+        }
+    }
+    stats_merge(&g->partial[worker], &acc);
+}
+
+/*
+ * step_colsum — Un paso completo con sumas de columna (el kernel de int
+ * o el de bytes segun el almacenamiento), incluido el swap. Retorna 0
+ * (sin tocar el grid) si no pudo alocar las sumas.
+ */
+static int step_colsum(Game *g) {
+    ColsumJob job;
+    size_t grain = STEP_GRAIN_CELLS / (size_t)g->width;
+    job.g = g;
+    job.stride = ((size_t)g->width + 2) * game_cell_bytes(g);
+    job.sums = malloc(job.stride * (size_t)pool_threads(g->pool));
+    if (!job.sums) return 0;
+    stats_begin(g);
+    pool_run(g->pool, (size_t)g->height, grain,
+             g->cells8 ? step_rows_colsum8 : step_rows_colsum, &job);
+    free(job.sums);
+    swap_buffers(g);
+    stats_end(g);
+    return 1;
+}
+
+/*
+ * BlockJob — Parametros compartidos por los threads de step_blocked.
+ *
+ * scratch tiene, por worker, dos buffers locales de un byte por celda
+ * de (GAME_BLOCK_CORE + 2 * gens)^2 bytes cada uno.
+ */
+typedef struct {
+    Game *g;
+    int gens;
+    int tiles_x;
+    unsigned char *scratch;
+    size_t scratch_stride;
+} BlockJob;
+
+/*
+ * step_local_row — Una fila del buffer local para x en [x0, x1): la
+ * misma formula sin branches que step_row_vector, sobre bytes.
+ */
+static void step_local_row(const unsigned char *up, const unsigned char *mid,
+                           const unsigned char *down, unsigned char *out,
+                           int x0, int x1) {
+    int x;
+    for (x = x0; x < x1; x++) {
+        int n = up[x - 1] + up[x] + up[x + 1] +
+                mid[x - 1] + mid[x + 1] +
+                down[x - 1] + down[x] + down[x + 1];
+        out[x] = (unsigned char)((n == 3) | (mid[x] & (n == 2)));
+    }
+}
+
+/*
+ * step_block_tiles — Trabajo paralelo de step_blocked sobre los tiles
+ * [begin, end).
+ *
+ * Para cada tile:
+ *   1. Carga el nucleo mas un halo de k = gens celdas en el buffer a
+ *      (local (0, 0) = celda (cx0 - k, cy0 - k) del grid); lo que cae
+ *      fuera del grid se carga como muerto. El buffer b se pone en cero.
+ *   2. Generacion i (1..k): calcula la region local [i, lado - i), que
+ *      solo lee la region valida de la generacion anterior; el halo
+ *      valido se achica una celda por lado en cada generacion, asi que
+ *      tras k generaciones el nucleo es exacto. Las celdas fuera del
+ *      grid nunca se escriben y siguen muertas en ambos buffers: son
+ *      los bordes muertos del automata.
+ *   3. Copia el nucleo al buffer next del Game, acumulando sus GameStats.
+ */
+static void step_block_tiles(void *ctx, size_t begin, size_t end, int worker) {
+    BlockJob *job = ctx;
+    Game *g = job->g;
+    const int k = job->gens;
+    unsigned char *a = job->scratch + (size_t)worker * job->scratch_stride;
+    unsigned char *b = a + job->scratch_stride / 2;
+    GameStats acc;
+    size_t t;
+    stats_reset(&acc);
+    for (t = begin; t < end; t++) {
+        int cx0 = (int)(t % (size_t)job->tiles_x) * GAME_BLOCK_CORE;
+        int cy0 = (int)(t / (size_t)job->tiles_x) * GAME_BLOCK_CORE;
+        int cw = g->width - cx0 < GAME_BLOCK_CORE ? g->width - cx0 : GAME_BLOCK_CORE;
+        int ch = g->height - cy0 < GAME_BLOCK_CORE ? g->height - cy0 : GAME_BLOCK_CORE;
+        int lw = cw + 2 * k, lh = ch + 2 * k;
+        int gx0 = cx0 - k, gy0 = cy0 - k;
+        /* Parte local que cae dentro del grid: [vx0, vx1) x [vy0, vy1) */
+        int vx0 = gx0 < 0 ? -gx0 : 0, vy0 = gy0 < 0 ? -gy0 : 0;
+        int vx1 = g->width - gx0 < lw ? g->width - gx0 : lw;
+        int vy1 = g->height - gy0 < lh ? g->height - gy0 : lh;
+        unsigned char *src = a, *dst = b, *tmp;
+        int x, y, i;
+
+        memset(a, 0, (size_t)lw * lh);
+        memset(b, 0, (size_t)lw * lh);
+        for (y = vy0; y < vy1; y++) {
+            size_t row = (size_t)(gy0 + y) * g->width + gx0;
+            unsigned char *local = a + (size_t)y * lw;
+            if (g->cells8) {
+                memcpy(local + vx0, g->cells8 + row + vx0, (size_t)(vx1 - vx0));
+            } else {
+                for (x = vx0; x < vx1; x++) local[x] = (unsigned char)g->cells[row + x];
+            }
+        }
+
+        for (i = 1; i <= k; i++) {
+            int y0 = vy0 > i ? vy0 : i, y1 = vy1 < lh - i ? vy1 : lh - i;
+            int x0 = vx0 > i ? vx0 : i, x1 = vx1 < lw - i ? vx1 : lw - i;
+            for (y = y0; y < y1; y++) {
+                const unsigned char *mid = src + (size_t)y * lw;
+                step_local_row(mid - lw, mid, mid + lw, dst + (size_t)y * lw, x0, x1);
+            }
+            tmp = src;
+            src = dst;
+            dst = tmp;
+        }
+
+        for (y = 0; y < ch; y++) {
+            const unsigned char *local = src + (size_t)(y + k) * lw + k;
+            size_t row = (size_t)(cy0 + y) * g->width + cx0;
+            if (g->next8) {
+                memcpy(g->next8 + row, local, (size_t)cw);
+            } else {
+                for (x = 0; x < cw; x++) g->next[row + x] = local[x];
+            }
+            stats_row8(&acc, local, cw, cx0, cy0 + y);
+        }
+    }
+    stats_merge(&g->partial[worker], &acc);
+}
+
+/*
+ * step_blocked — Una pasada de gens generaciones con bloqueo temporal.
+ * Los buffers locales se alocan por pasada (son chicos frente al grid).
+ * Retorna 0 si no pudieron alocarse, sin modificar el grid.
+ */
+static int step_blocked(Game *g, int gens) {
+    BlockJob job;
+    size_t side = (size_t)GAME_BLOCK_CORE + 2 * (size_t)gens;
+    int tiles_y = (g->height + GAME_BLOCK_CORE - 1) / GAME_BLOCK_CORE;
+    job.g = g;
+    job.gens = gens;
+    job.tiles_x = (g->width + GAME_BLOCK_CORE - 1) / GAME_BLOCK_CORE;
+    job.scratch_stride = 2 * side * side;
+    job.scratch = malloc(job.scratch_stride * (size_t)pool_threads(g->pool));
+    if (!job.scratch) return 0;
+    stats_begin(g);
+    pool_run(g->pool, (size_t)job.tiles_x * tiles_y, 1, step_block_tiles, &job);
+    free(job.scratch);
+    swap_buffers(g);
+    stats_end(g);
+    return 1;
+}
+
+/*
+ * step_generation — Avanza una generacion aplicando las reglas de Conway.
+ *
+ * Las filas se reparten en tramos contiguos entre los threads del pool
+ * (con un minimo de STEP_GRAIN_CELLS celdas por tramo, para que un grid
+ * chico no pague sincronizacion). Cada celda depende solo de cells, asi
+ * que el resultado es identico con cualquier engine y cantidad de threads.
  *
  * Al finalizar, intercambia los punteros cells y next mediante una
  * variable temporal. Esto evita copiar width*height enteros y convierte
  * el swap en una operacion O(1) de tres asignaciones de puntero.
  */
+static void step_generation(Game *g) {
+    if (g->engine == GAME_ENGINE_BLOCKED && !g->heat && step_blocked(g, 1)) return;
+    if (g->engine == GAME_ENGINE_COLSUM && step_colsum(g)) return;
+    size_t grain = g->width > 0 ? STEP_GRAIN_CELLS / (size_t)g->width : 1;
+    stats_begin(g);
+    if (g->engine == GAME_ENGINE_LUT)
+        pool_run(g->pool, ((size_t)g->height + 1) / 2, grain / 2 + 1, step_pairs_lut, g);
+    else
+        pool_run(g->pool, (size_t)g->height, grain, step_rows, g);
+    /* Swap de punteros: O(1) en lugar de memcpy O(n) */
+    swap_buffers(g);
+    stats_end(g);
+}
+
+/*
+ * game_step — step_generation, medido como PROFILE_STEP y registrado
+ * como "step" en el trace.
+ */
 void game_step(Game *g) {
-    int x, y;
-    for (y = 0; y < g->height; y++) {
-        for (x = 0; x < g->width; x++) {
-            int n = count_neighbors(g, x, y);
-            int alive = g->cells[y * g->width + x];
-            if (alive) {
-                /* Reglas 1-3: viva con 2 o 3 vecinos sobrevive, si no muere */
-                g->next[y * g->width + x] = (n == 2 || n == 3) ? 1 : 0;
-            } else {
-                /* Regla 4: muerta con exactamente 3 vecinos nace */
-                g->next[y * g->width + x] = (n == 3) ? 1 : 0;
-            }
+    TRACE_BEGIN(tt);
+    PROFILE_START(t);
+    step_generation(g);
+    PROFILE_STOP(PROFILE_STEP, t);
+    TRACE_END(TRACE_STEP, 0, tt);
+}
+
+/*
+ * game_step_n — Con GAME_ENGINE_BLOCKED, pasadas de hasta time_block
+ * generaciones; si no (o si falta memoria para los buffers locales),
+ * game_step repetido.
+ */
+void game_step_n(Game *g, int n) {
+    while (n > 0) {
+        int gens = n < g->time_block ? n : g->time_block;
+        TRACE_BEGIN(tt);
+        PROFILE_START(t);
+        if (g->engine != GAME_ENGINE_BLOCKED || g->heat || !step_blocked(g, gens)) {
+            game_step(g);
+            gens = 1;
+        } else {
+            PROFILE_STOP(PROFILE_PASS, t);
+            TRACE_END(TRACE_STEP, 0, tt);
         }
+        n -= gens;
     }
-    /* Swap de punteros: O(1) en lugar de memcpy O(n) */
-    int *tmp = g->cells;
-    g->cells = g->next;
-    g->next = tmp;
+}
+
+void game_set_time_block(Game *g, int k) {
+    if (k < 1) k = 1;
+    if (k > GAME_TIME_BLOCK_MAX) k = GAME_TIME_BLOCK_MAX;
+    g->time_block = k;
 }
 
 /*
- * game_randomize — Poblacion aleatoria del grid.
- *
- * Para cada celda genera un float aleatorio en [0, 1) usando
- * rand() / RAND_MAX. Si el valor es menor que density, la celda
- * se marca como viva. Un density de 0.3 produce aproximadamente
- * un 30% de celdas vivas, que es un buen punto de partida para
- * observar patrones emergentes.
+ * game_set_engine — La tabla de GAME_ENGINE_LUT se genera aqui, antes
+ * de cualquier paso con ese engine, asi los workers solo la leen.
+ */
+void game_set_engine(Game *g, GameEngine engine) {
+    if (engine < 0 || engine >= GAME_ENGINE_COUNT) return;
+    if (engine == GAME_ENGINE_LUT) pthread_once(&lut_once, build_lut);
+    g->engine = engine;
+}
+
+const char *game_engine_name(GameEngine engine) {
+    if (engine < 0 || engine >= GAME_ENGINE_COUNT) return "unknown";
+    return engine_names[engine];
+}
+
+int game_engine_from_name(const char *name, GameEngine *out) {
+    int e;
+    for (e = 0; e < GAME_ENGINE_COUNT; e++) {
+        if (strcmp(name, engine_names[e]) == 0) {
+            *out = (GameEngine)e;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * game_hash — Empaqueta las celdas en palabras de 64 (mismo mapeo lineal
+ * que game_randomize, normalizando cada celda a 0/1) y las encadena con
+ * el finalizador de SplitMix64: h = mix64(h ^ palabra). mix64 es una
+ * biyeccion, asi que el hash depende del orden y de cada bit. El valor
+ * inicial incluye las dimensiones, para distinguir grids del mismo
+ * contenido lineal pero distinta forma.
+ */
+uint64_t game_hash(const Game *g) {
+    size_t size = game_cell_count(g);
+    uint64_t h = rng_mix64(((uint64_t)(unsigned)g->width << 32) | (unsigned)g->height);
+    size_t i, b;
+    for (i = 0; i < size; i += 64) {
+        size_t n = size - i < 64 ? size - i : 64;
+        uint64_t bits = 0;
+        if (g->cells8) {
+            for (b = 0; b < n; b++)
+                bits |= (uint64_t)(g->cells8[i + b] != 0) << b;
+        } else {
+            for (b = 0; b < n; b++)
+                bits |= (uint64_t)(g->cells[i + b] != 0) << b;
+        }
+        h = rng_mix64(h ^ bits);
+    }
+    return h;
+}
+
+/*
+ * game_stats — Si stats no es valido (se escribieron celdas despues del
+ * ultimo paso), lo recalcula recorriendo cells fila por fila.
+ */
+void game_stats(Game *g, GameStats *out) {
+    if (!g->stats_valid) {
+        size_t row;
+        int y;
+        stats_reset(&g->stats);
+        for (y = 0; y < g->height; y++) {
+            row = (size_t)y * g->width;
+            if (g->cells8) stats_row8(&g->stats, g->cells8 + row, g->width, 0, y);
+            else stats_row(&g->stats, g->cells + row, g->width, 0, y);
+        }
+        stats_close(&g->stats);
+        g->stats_valid = 1;
+    }
+    *out = g->stats;
+}
+
+size_t game_memory(const Game *g) {
+    size_t cells = (size_t)g->width * (size_t)g->height;
+    return 2 * cells * game_cell_bytes(g) + (g->heat ? cells : 0);
+}
+
+/*
+ * RandomizeJob — Parametros compartidos por los threads de game_randomize.
+ */
+typedef struct {
+    Game *g;
+    uint64_t seed;
+    unsigned threshold;
+} RandomizeJob;
+
+/*
+ * randomize_words — Llena las palabras [begin, end) del grid.
  *
- * Nota: rand() no es criptograficamente seguro ni tiene la mejor
- * distribucion, pero es suficiente para este proposito visual.
+ * La palabra w cubre las celdas lineales [64w, 64w + 64) del array
+ * (puede cruzar filas: el mapeo es sobre el array 1D). Cada palabra es
+ * rng_bernoulli64(seed, w), que depende solo de w y no de que thread la
+ * calcula; despues se desempaqueta bit a bit en celdas int o bytes, un loop
+ * sin dependencias que el compilador vectoriza.
  */
-void game_randomize(Game *g, float density) {
-    int x, y;
-    for (y = 0; y < g->height; y++) {
-        for (x = 0; x < g->width; x++) {
-            float r = (float)rand() / (float)RAND_MAX;
-            g->cells[y * g->width + x] = (r < density) ? 1 : 0;
+static void randomize_words(void *ctx, size_t begin, size_t end, int worker) {
+    RandomizeJob *job = ctx;
+    size_t size = game_cell_count(job->g);
+    size_t w;
+    (void)worker;
+    for (w = begin; w < end; w++) {
+        uint64_t bits = rng_bernoulli64(job->seed, w, job->threshold);
+        size_t n = size - w * 64 < 64 ? size - w * 64 : 64;
+        size_t b;
+        if (job->g->cells8) {
+            unsigned char *out = job->g->cells8 + w * 64;
+            for (b = 0; b < n; b++) out[b] = (unsigned char)((bits >> b) & 1u);
+        } else {
+            int *out = job->g->cells + w * 64;
+            for (b = 0; b < n; b++) out[b] = (int)((bits >> b) & 1u);
         }
     }
 }
 
+/*
+ * game_randomize — Poblacion aleatoria del grid.
+ *
+ * En lugar de un rand() y una division de punto flotante por celda,
+ * cada palabra de 64 celdas se obtiene con pocas operaciones enteras
+ * (una sola para densidad 0.5, como maximo RNG_DENSITY_BITS). Las
+ * palabras se reparten entre los threads del pool; como cada palabra
+ * depende solo de (seed, indice), el grid resultante es identico con
+ * cualquier cantidad de threads. Un density de 0.3 produce
+ * aproximadamente un 30% de celdas vivas, que es un buen punto de
+ * partida para observar patrones emergentes.
+ *
+ * Los contadores heat se reinician: el grid nuevo no tiene historia.
+ */
+void game_randomize(Game *g, float density, uint64_t seed) {
+    RandomizeJob job;
+    size_t words = (game_cell_count(g) + 63) / 64;
+    job.g = g;
+    job.seed = seed;
+    job.threshold = rng_density_threshold(density);
+    pool_run(g->pool, words, RANDOMIZE_GRAIN, randomize_words, &job);
+    g->stats_valid = 0;
+    if (g->heat) memset(g->heat, 0, game_cell_count(g));
+}
+
 /*
  * game_clear — Reinicia ambos buffers a cero.
  *
- * Usa memset sobre el tamanio total (width * height * sizeof(int)).
+ * Usa memset sobre el tamanio total (width * height * bytes por celda,
+ * en size_t: no desborda aunque el grid supere 2^31 celdas).
  * Se limpian ambos buffers para evitar que datos residuales del buffer
  * next aparezcan en la siguiente generacion tras un swap.
  */
 void game_clear(Game *g) {
-    memset(g->cells, 0, g->width * g->height * sizeof(int));
-    memset(g->next, 0, g->width * g->height * sizeof(int));
+    size_t size = game_cell_count(g);
+    stats_reset(&g->stats);
+    stats_close(&g->stats);
+    g->stats_valid = 1;
+    if (g->cells8) {
+        memset(g->cells8, 0, size);
+        memset(g->next8, 0, size);
+    } else {
+        memset(g->cells, 0, size * sizeof(int));
+        memset(g->next, 0, size * sizeof(int));
+    }
+    if (g->heat) memset(g->heat, 0, size);
 }
@@ -9,11 +9,131 @@
  * El grid se almacena como un array unidimensional de enteros donde
  * la posicion (x, y) se mapea al indice [y * width + x]. Las celdas
  * fuera de los limites del grid se consideran muertas (bordes no toroidales).
+ * Cada dimension es un int, pero los indices y tamanios se calculan en
+ * size_t: un grid de 65536x65536 (2^32 celdas) es valido.
+ *
+ * Opcionalmente se mantiene un tercer buffer de un byte por celda (heat)
+ * con la edad de cada celda o su frecuencia de cambio reciente, que el
+ * renderer usa para el modo heatmap. Se actualiza en la misma pasada que
+ * game_step y no existe (NULL) cuando el tracking esta desactivado.
  */
 
 #ifndef GAME_H
 #define GAME_H
 
+#include <stdint.h>     /* uint64_t */
+#include "parallel.h"   /* ThreadPool */
+
+/*
+ * GameTrack — Tipo de informacion que acumula el buffer heat.
+ *
+ * GAME_TRACK_NONE     — Sin tracking: heat es NULL, costo cero en game_step.
+ * GAME_TRACK_AGE      — Generaciones consecutivas que la celda lleva viva,
+ *                       saturando en 255. Una celda muerta tiene edad 0.
+ * GAME_TRACK_ACTIVITY — Frecuencia de cambio reciente: cada nacimiento o
+ *                       muerte suma GAME_ACTIVITY_BUMP (saturando en 255) y
+ *                       cada generacion sin cambios decae el valor ~1/8.
+ */
+typedef enum {
+    GAME_TRACK_NONE,
+    GAME_TRACK_AGE,
+    GAME_TRACK_ACTIVITY
+} GameTrack;
+
+/* Incremento de actividad por cada cambio de estado de una celda */
+#define GAME_ACTIVITY_BUMP 64
+
+/*
+ * Flags de alocacion y almacenamiento de game_create_ex (combinables
+ * con |).
+ *
+ * GAME_ALLOC_MMAP      — Buffers con mmap anonimo en lugar de calloc. Las
+ *                        paginas se obtienen ya en cero y bajo demanda, y
+ *                        se devuelven al sistema completas al destruir.
+ * GAME_ALLOC_HUGEPAGES — Ademas alinea cada buffer a 2 MiB y pide
+ *                        transparent huge pages (madvise MADV_HUGEPAGE).
+ *                        Menos entradas de TLB para recorrer el grid; es
+ *                        un pedido, no una garantia, y donde no existe
+ *                        (macOS) equivale a GAME_ALLOC_MMAP. Implica MMAP.
+ */
+#define GAME_ALLOC_MMAP      0x1u
+#define GAME_ALLOC_HUGEPAGES 0x2u
+
+/*
+ * GAME_CELLS_BYTES — Un byte por celda (cells8/next8) en lugar de un int
+ *                    (cells/next, que quedan en NULL). El grid ocupa la
+ *                    cuarta parte: entran 4 veces mas filas en cache y
+ *                    el kernel de bytes procesa 4 veces mas celdas por
+ *                    registro vectorial. Las celdas se leen y escriben
+ *                    igual, con game_get_cell/game_set_cell.
+ */
+#define GAME_CELLS_BYTES     0x4u
+
+/*
+ * GameEngine — Kernel que usa game_step para calcular una generacion.
+ *
+ * GAME_ENGINE_SCALAR — Referencia: cuenta los 8 vecinos de cada celda con
+ *                      game_get_cell (verificacion de limites por vecino).
+ * GAME_ENGINE_VECTOR — Filas interiores sin branches: suma directa de tres
+ *                      punteros de fila, un loop que el compilador
+ *                      vectoriza. Los bordes usan el camino escalar.
+ * GAME_ENGINE_BLOCKED — Bloqueo temporal: cada tile de GAME_BLOCK_CORE x
+ *                      GAME_BLOCK_CORE celdas se copia con un halo de k
+ *                      celdas a un buffer local de un byte por celda y
+ *                      avanza k generaciones ahi, mientras entra en L1/L2;
+ *                      luego solo el nucleo se escribe en next. El halo
+ *                      se recalcula de mas, a cambio de recorrer el grid
+ *                      en memoria una vez cada k generaciones (ver
+ *                      game_step_n y game_set_time_block). Con el
+ *                      heatmap activo, que necesita cada generacion,
+ *                      se comporta como GAME_ENGINE_VECTOR.
+ * GAME_ENGINE_LUT    — Tabla de 65536 entradas generada desde la regla:
+ *                      cada bloque de 4x4 celdas indexa directamente su
+ *                      resultado 2x2, asi que una busqueda calcula cuatro
+ *                      celdas y cada celda de entrada se lee dos veces
+ *                      en lugar de nueve.
+ * GAME_ENGINE_COLSUM — Sumas verticales de 3 celdas por columna que se
+ *                      actualizan al bajar de fila (entra una celda, sale
+ *                      otra); cada celda es la suma de 3 columnas
+ *                      vecinas. Conserva el layout simple del grid.
+ *
+ * Con GAME_CELLS_BYTES cada engine tiene su propia version sobre bytes.
+ *
+ * Todos los engines producen exactamente el mismo grid, con cualquier
+ * cantidad de threads; game_hash permite comprobarlo.
+ */
+typedef enum {
+    GAME_ENGINE_SCALAR,
+    GAME_ENGINE_VECTOR,
+    GAME_ENGINE_BLOCKED,
+    GAME_ENGINE_LUT,
+    GAME_ENGINE_COLSUM,
+    GAME_ENGINE_COUNT
+} GameEngine;
+
+/* Lado del nucleo de un tile de GAME_ENGINE_BLOCKED, en celdas */
+#define GAME_BLOCK_CORE 128
+
+/* Generaciones por pasada de GAME_ENGINE_BLOCKED: default y maximo */
+#define GAME_TIME_BLOCK_DEFAULT 8
+#define GAME_TIME_BLOCK_MAX 32
+
+/*
+ * GameStats — Resumen de la generacion actual.
+ *
+ * population — Celdas vivas.
+ * min_x, min_y, max_x, max_y — Bounding box de las celdas vivas, con
+ *              ambos extremos incluidos. Si population es 0 no hay caja
+ *              y los cuatro valen -1.
+ */
+typedef struct {
+    uint64_t population;
+    int min_x;
+    int min_y;
+    int max_x;
+    int max_y;
+} GameStats;
+
 /*
  * Estructura principal del juego.
  *
@@ -23,12 +143,41 @@
  *           Cada elemento es 0 (muerta) o 1 (viva).
  * next   — Buffer secundario donde se escribe la siguiente generacion.
  *           Tras cada paso, cells y next se intercambian por puntero.
+ * cells8, next8 — Los mismos buffers con un byte por celda cuando el
+ *           Game se creo con GAME_CELLS_BYTES; si no, NULL. En cada Game
+ *           existe exactamente uno de los dos pares.
+ * track  — Modo de tracking activo (ver GameTrack).
+ * heat   — Contadores saturados uint8 de tamanio width*height, o NULL
+ *           si track es GAME_TRACK_NONE.
+ * pool   — Pool de threads para las operaciones paralelas, o NULL para
+ *           ejecutar todo en el thread que llama (ver game_set_threads).
+ * engine — Kernel de game_step (ver GameEngine).
+ * time_block — Generaciones por pasada (k) de GAME_ENGINE_BLOCKED.
+ * alloc  — Flags GAME_ALLOC_* y GAME_CELLS_BYTES con que se alocaron
+ *           los buffers; los usa game_destroy para liberarlos de la misma
+ *           forma.
+ * stats  — GameStats de cells, valido si stats_valid es distinto de 0.
+ *           game_step lo calcula en la misma pasada que la generacion;
+ *           escribir celdas lo corrige o, si no es posible, lo invalida.
+ * partial — Un GameStats parcial por worker del pool, que game_step
+ *           combina en stats al terminar.
  */
 typedef struct {
     int width;
     int height;
     int *cells;
     int *next;
+    unsigned char *cells8;
+    unsigned char *next8;
+    GameTrack track;
+    unsigned char *heat;
+    ThreadPool *pool;
+    GameEngine engine;
+    int time_block;
+    unsigned alloc;
+    GameStats stats;
+    int stats_valid;
+    GameStats *partial;
 } Game;
 
 /*
@@ -38,6 +187,15 @@ typedef struct {
  */
 Game *game_create(int width, int height);
 
+/*
+ * game_create_ex — Como game_create, con flags GAME_ALLOC_* para elegir
+ * como se alocan los buffers (modo de grids grandes) y GAME_CELLS_BYTES
+ * para el almacenamiento de un byte por celda. Retorna NULL si
+ * las dimensiones no son positivas, si el tamanio en bytes desborda
+ * size_t o si la alocacion falla.
+ */
+Game *game_create_ex(int width, int height, unsigned alloc);
+
 /*
  * game_destroy — Libera ambos buffers y la estructura Game.
  * Acepta NULL de forma segura (no-op).
@@ -48,10 +206,83 @@ void game_destroy(Game *g);
  * game_step — Avanza la simulacion una generacion.
  * Recorre cada celda, cuenta sus 8 vecinos en el buffer actual,
  * aplica las reglas de Conway y escribe el resultado en el buffer next.
+ * Las filas se reparten entre los threads del pool.
  * Finalmente intercambia los punteros cells y next (swap sin copia).
  */
 void game_step(Game *g);
 
+/*
+ * game_step_n — Avanza la simulacion n generaciones. Equivale a n
+ * llamadas a game_step; con GAME_ENGINE_BLOCKED las agrupa en pasadas de
+ * time_block generaciones.
+ */
+void game_step_n(Game *g, int n);
+
+/*
+ * game_set_engine — Selecciona el kernel de game_step. El default de
+ * game_create es GAME_ENGINE_VECTOR.
+ */
+void game_set_engine(Game *g, GameEngine engine);
+
+/*
+ * game_set_time_block — Generaciones por pasada de GAME_ENGINE_BLOCKED,
+ * limitadas a [1, GAME_TIME_BLOCK_MAX]. Un k mayor reduce el trafico de
+ * memoria pero agranda el halo recalculado: en la primera generacion de
+ * cada pasada se calculan (GAME_BLOCK_CORE + 2k - 2)^2 celdas por tile en
+ * lugar de GAME_BLOCK_CORE^2, y el excedente se reduce en cada una.
+ */
+void game_set_time_block(Game *g, int k);
+
+/*
+ * game_engine_name — Nombre de linea de comandos del engine
+ * ("scalar", "vector", "blocked", "lut", "colsum").
+ */
+const char *game_engine_name(GameEngine engine);
+
+/*
+ * game_engine_from_name — Traduce un nombre de engine. Retorna 1 y
+ * escribe *out si el nombre es valido; 0 si no.
+ */
+int game_engine_from_name(const char *name, GameEngine *out);
+
+/*
+ * game_hash — Huella de 64 bits del estado del grid (dimensiones y
+ * celdas vivas). Dos grids con el mismo hash son, en la practica,
+ * identicos: sirve para comparar corridas entre engines, cantidades de
+ * threads y maquinas. No depende del buffer heat.
+ */
+uint64_t game_hash(const Game *g);
+
+/*
+ * game_stats — Poblacion y bounding box de la generacion actual. Tras
+ * game_step son un subproducto del paso y la lectura es O(1). Las
+ * ediciones chicas (game_set_cell, regiones de hasta un octavo del grid)
+ * los corrigen con las celdas que tocan; tras una edicion grande
+ * (game_randomize, importar el grid entero) o que achica la caja, se
+ * recalculan con un recorrido del grid y quedan guardadas.
+ */
+void game_stats(Game *g, GameStats *out);
+
+/*
+ * game_memory — Bytes de los buffers del grid: cells/next (o cells8/next8)
+ * y heat si esta activo.
+ */
+size_t game_memory(const Game *g);
+
+/*
+ * game_set_threads — Configura cuantos threads usan las operaciones
+ * paralelas del Game. nthreads <= 1 vuelve al modo de un solo thread.
+ * Retorna 1 en exito, 0 si no pudo crearse el pool (queda en 1 thread).
+ */
+int game_set_threads(Game *g, int nthreads);
+
+/*
+ * game_set_tracking — Activa, cambia o desactiva el buffer heat.
+ * Al activarlo se aloca el buffer a cero; al desactivarlo se libera.
+ * Retorna 1 en exito, 0 si la alocacion falla (el modo no cambia).
+ */
+int game_set_tracking(Game *g, GameTrack mode);
+
 /*
  * game_set_cell — Establece el estado de la celda en (x, y).
  * alive != 0 la marca como viva; alive == 0 como muerta.
@@ -66,16 +297,75 @@ void game_set_cell(Game *g, int x, int y, int alive);
  */
 int game_get_cell(Game *g, int x, int y);
 
+/*
+ * GameBlend — Como game_write_region y game_write_bits combinan cada
+ * celda escrita (s) con la del grid (d).
+ *
+ * GAME_BLEND_COPY — d = s, reemplaza la region.
+ * GAME_BLEND_OR   — d = d | s, agrega las vivas (estampar un patron).
+ * GAME_BLEND_XOR  — d = d ^ s, invierte donde s esta viva.
+ * GAME_BLEND_AND  — d = d & s, conserva solo lo cubierto por s (mascara).
+ */
+typedef enum {
+    GAME_BLEND_COPY,
+    GAME_BLEND_OR,
+    GAME_BLEND_XOR,
+    GAME_BLEND_AND
+} GameBlend;
+
+/*
+ * Acceso por regiones: copian el rectangulo de w x h celdas con esquina
+ * superior izquierda en (x, y) desde o hacia un buffer del llamador,
+ * fila por fila, sin verificar limites por celda. La celda (x + i, y + j)
+ * corresponde a:
+ *   - Region de bytes: buf[j * stride + i], 0 = muerta, 1 = viva (otros
+ *     valores no estan permitidos al escribir).
+ *   - Bitmap: el bit (i % 8) (0 = menos significativo) del byte
+ *     buf[j * stride + i / 8].
+ * La parte del rectangulo fuera del grid se lee como muerta y se ignora
+ * al escribir, igual que game_get_cell y game_set_cell.
+ */
+
+/*
+ * game_read_region — Copia la region a dst, un byte por celda.
+ */
+void game_read_region(const Game *g, int x, int y, int w, int h,
+                      unsigned char *dst, size_t stride);
+
+/*
+ * game_write_region — Combina src (un byte por celda) con la region.
+ */
+void game_write_region(Game *g, int x, int y, int w, int h,
+                       const unsigned char *src, size_t stride, GameBlend blend);
+
+/*
+ * game_read_bits — Copia la region a dst como bitmap de un bit por
+ * celda; cada fila ocupa (w + 7) / 8 bytes y los bits sobrantes quedan
+ * en 0.
+ */
+void game_read_bits(const Game *g, int x, int y, int w, int h,
+                    unsigned char *dst, size_t stride);
+
+/*
+ * game_write_bits — Combina el bitmap src con la region.
+ */
+void game_write_bits(Game *g, int x, int y, int w, int h,
+                     const unsigned char *src, size_t stride, GameBlend blend);
+
 /*
  * game_randomize — Llena el grid con celulas vivas de forma aleatoria.
  * density es un valor entre 0.0 y 1.0 que indica la probabilidad
- * de que cada celda individual este viva. Usa rand() de stdlib.
+ * de que cada celda individual este viva (cuantizada a 1/256).
+ * Usa el generador por contador de rng.h: la misma semilla, densidad y
+ * tamanio producen siempre el mismo grid, con cualquier cantidad de
+ * threads.
  */
-void game_randomize(Game *g, float density);
+void game_randomize(Game *g, float density, uint64_t seed);
 
 /*
  * game_clear — Establece todas las celdas a 0 (muertas) en ambos buffers.
- * Utiliza memset para eficiencia sobre el array completo.
+ * Utiliza memset para eficiencia sobre el array completo. Tambien
+ * reinicia el buffer heat si el tracking esta activo.
  */
 void game_clear(Game *g);
 
@@ -0,0 +1,142 @@
+/*
+ * gol.c — Implementacion de gol.h sobre Game (game.h) y patterns.h.
+ *
+ * GolGrid envuelve un Game: cada funcion traduce la convencion de la
+ * API publica (nombres en lugar de enums, bytes 0/1, long para cuentas
+ * de generaciones) a las funciones internas.
+ */
+
+#include <stdlib.h>   /* malloc, free */
+#include <limits.h>   /* INT_MAX */
+#include "gol.h"
+#include "game.h"
+#include "patterns.h"
+
+struct GolGrid {
+    Game *game;
+};
+
+int gol_api_version(void) {
+    return GOL_API_VERSION;
+}
+
+GolGrid *gol_create(int width, int height, unsigned flags) {
+    GolGrid *g = malloc(sizeof(GolGrid));
+    unsigned alloc = 0;
+    if (!g) return NULL;
+    if (flags & GOL_BYTE_CELLS) alloc |= GAME_CELLS_BYTES;
+    if (flags & GOL_LARGE_GRID) alloc |= GAME_ALLOC_MMAP;
+    g->game = game_create_ex(width, height, alloc);
+    if (!g->game) {
+        free(g);
+        return NULL;
+    }
+    return g;
+}
+
+void gol_destroy(GolGrid *g) {
+    if (!g) return;
+    game_destroy(g->game);
+    free(g);
+}
+
+int gol_width(const GolGrid *g) {
+    return g->game->width;
+}
+
+int gol_height(const GolGrid *g) {
+    return g->game->height;
+}
+
+int gol_set_threads(GolGrid *g, int nthreads) {
+    return game_set_threads(g->game, nthreads);
+}
+
+int gol_set_engine(GolGrid *g, const char *name) {
+    GameEngine engine;
+    if (!game_engine_from_name(name, &engine)) return 0;
+    game_set_engine(g->game, engine);
+    return 1;
+}
+
+void gol_step(GolGrid *g) {
+    game_step(g->game);
+}
+
+/*
+ * gol_step_n — game_step_n recibe int: las cuentas mayores se dividen
+ * en tramos de INT_MAX generaciones.
+ */
+void gol_step_n(GolGrid *g, long n) {
+    while (n > 0) {
+        int gens = n < INT_MAX ? (int)n : INT_MAX;
+        game_step_n(g->game, gens);
+        n -= gens;
+    }
+}
+
+int gol_get(const GolGrid *g, int x, int y) {
+    return game_get_cell(g->game, x, y) != 0;
+}
+
+void gol_set(GolGrid *g, int x, int y, int alive) {
+    game_set_cell(g->game, x, y, alive != 0);
+}
+
+void gol_clear(GolGrid *g) {
+    game_clear(g->game);
+}
+
+void gol_randomize(GolGrid *g, double density, uint64_t seed) {
+    game_randomize(g->game, (float)density, seed);
+}
+
+int gol_place_pattern(GolGrid *g, const char *name, int x, int y) {
+    PatternType type;
+    if (!pattern_from_name(name, &type)) return 0;
+    pattern_load(g->game, type, x, y);
+    return 1;
+}
+
+void gol_import(GolGrid *g, const unsigned char *cells, size_t stride) {
+    game_write_region(g->game, 0, 0, g->game->width, g->game->height, cells, stride,
+                      GAME_BLEND_COPY);
+}
+
+void gol_export(const GolGrid *g, unsigned char *cells, size_t stride) {
+    game_read_region(g->game, 0, 0, g->game->width, g->game->height, cells, stride);
+}
+
+/*
+ * Regiones — GolBlend y GameBlend tienen los mismos valores en el mismo
+ * orden, asi que la conversion es directa.
+ */
+void gol_read_region(const GolGrid *g, int x, int y, int w, int h,
+                     unsigned char *dst, size_t stride) {
+    game_read_region(g->game, x, y, w, h, dst, stride);
+}
+
+void gol_write_region(GolGrid *g, int x, int y, int w, int h,
+                      const unsigned char *src, size_t stride, GolBlend blend) {
+    game_write_region(g->game, x, y, w, h, src, stride, (GameBlend)blend);
+}
+
+void gol_read_bits(const GolGrid *g, int x, int y, int w, int h,
+                   unsigned char *dst, size_t stride) {
+    game_read_bits(g->game, x, y, w, h, dst, stride);
+}
+
+void gol_write_bits(GolGrid *g, int x, int y, int w, int h,
+                    const unsigned char *src, size_t stride, GolBlend blend) {
+    game_write_bits(g->game, x, y, w, h, src, stride, (GameBlend)blend);
+}
+
+uint64_t gol_population(GolGrid *g) {
+    GameStats stats;
+    game_stats(g->game, &stats);
+    return stats.population;
+}
+
+uint64_t gol_hash(const GolGrid *g) {
+    return game_hash(g->game);
+}
@@ -0,0 +1,179 @@
+/*
+ * gol.h — API publica de libgol, el motor del Game of Life sin SDL2.
+ *
+ * Pensada para embeber la simulacion en otros programas enlazando
+ * libgol.a o libgol.so. El grid es un handle opaco (GolGrid): la
+ * representacion interna (celdas int o de un byte, engines, pool de
+ * threads) puede cambiar sin romper a quien use solo esta interfaz.
+ * Las funciones y tipos internos (game.h y los demas headers de src/)
+ * no son parte de la API estable y no se exportan de libgol.so.
+ *
+ * Convenciones:
+ *   - Coordenadas (x, y) con 0 <= x < ancho, 0 <= y < alto; fuera del
+ *     grid gol_get retorna 0 y gol_set no hace nada.
+ *   - Las celdas fuera del grid cuentan como muertas (bordes fijos).
+ *   - Un GolGrid no es thread-safe: cada handle debe usarse desde un
+ *     thread a la vez. gol_step reparte el trabajo en sus propios
+ *     threads (gol_set_threads).
+ *   - Funciones que pueden fallar retornan 1 en exito y 0 en error.
+ *
+ * Compatible con C++ (extern "C").
+ */
+
+#ifndef GOL_H
+#define GOL_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Version de la API; cambia solo ante cambios incompatibles */
+#define GOL_API_VERSION 1
+
+/* Simbolos exportados de libgol.so (el resto se compila oculto) */
+#if defined(__GNUC__)
+#define GOL_API __attribute__((visibility("default")))
+#else
+#define GOL_API
+#endif
+
+/* Flags de gol_create */
+#define GOL_BYTE_CELLS 0x1u   /* Un byte por celda en lugar de un int */
+#define GOL_LARGE_GRID 0x2u   /* Buffers con mmap (paginas bajo demanda) */
+
+typedef struct GolGrid GolGrid;
+
+/*
+ * gol_api_version — GOL_API_VERSION con la que se compilo la biblioteca,
+ * para detectar un libgol.so incompatible en tiempo de ejecucion.
+ */
+GOL_API int gol_api_version(void);
+
+/*
+ * gol_create — Grid de width x height celdas muertas, con un thread y
+ * el engine por defecto. flags es una combinacion de GOL_*. Retorna
+ * NULL si las dimensiones no son positivas o falla la alocacion.
+ */
+GOL_API GolGrid *gol_create(int width, int height, unsigned flags);
+
+/*
+ * gol_destroy — Libera el grid y detiene sus threads. Acepta NULL.
+ */
+GOL_API void gol_destroy(GolGrid *g);
+
+GOL_API int gol_width(const GolGrid *g);
+GOL_API int gol_height(const GolGrid *g);
+
+/*
+ * gol_set_threads — Threads para gol_step (1 = sin pool). Retorna 0 si
+ * no pudieron crearse; el grid sigue funcionando con un thread.
+ */
+GOL_API int gol_set_threads(GolGrid *g, int nthreads);
+
+/*
+ * gol_set_engine — Kernel de gol_step por nombre: "scalar", "vector",
+ * "blocked", "lut" o "colsum". Todos dan el mismo resultado. Retorna 0
+ * si el nombre no existe (el engine no cambia).
+ */
+GOL_API int gol_set_engine(GolGrid *g, const char *name);
+
+/*
+ * gol_step — Avanza una generacion.
+ */
+GOL_API void gol_step(GolGrid *g);
+
+/*
+ * gol_step_n — Avanza n generaciones (n <= 0 no hace nada). Con el
+ * engine "blocked" varias generaciones se calculan por pasada.
+ */
+GOL_API void gol_step_n(GolGrid *g, long n);
+
+/*
+ * gol_get — 1 si la celda (x, y) esta viva, 0 si no.
+ */
+GOL_API int gol_get(const GolGrid *g, int x, int y);
+
+/*
+ * gol_set — Establece la celda (x, y): viva si alive != 0.
+ */
+GOL_API void gol_set(GolGrid *g, int x, int y, int alive);
+
+/*
+ * gol_clear — Mata todas las celdas.
+ */
+GOL_API void gol_clear(GolGrid *g);
+
+/*
+ * gol_randomize — Llena el grid con densidad density (0.0 - 1.0). El
+ * resultado depende solo de (seed, tamanio, densidad).
+ */
+GOL_API void gol_randomize(GolGrid *g, double density, uint64_t seed);
+
+/*
+ * gol_place_pattern — Coloca un patron predefinido ("glider",
+ * "blinker", "toad", "beacon", "pulsar", "gosper") con la esquina
+ * superior izquierda en (x, y). Retorna 0 si el nombre no existe.
+ */
+GOL_API int gol_place_pattern(GolGrid *g, const char *name, int x, int y);
+
+/*
+ * gol_import — Reemplaza todo el grid desde cells, un byte por celda
+ * (1 = viva, 0 = muerta; otros valores no estan permitidos), con la
+ * celda (x, y) en cells[y * stride + x].
+ * Un stride mayor que el ancho permite importar desde un buffer con
+ * padding.
+ */
+GOL_API void gol_import(GolGrid *g, const unsigned char *cells, size_t stride);
+
+/*
+ * gol_export — Escribe todo el grid en cells con el formato de
+ * gol_import (1 = viva, 0 = muerta).
+ */
+GOL_API void gol_export(const GolGrid *g, unsigned char *cells, size_t stride);
+
+/*
+ * GolBlend — Combinacion de las celdas escritas (s) con las del grid (d)
+ * en gol_write_region y gol_write_bits.
+ */
+typedef enum {
+    GOL_BLEND_COPY,   /* d = s */
+    GOL_BLEND_OR,     /* d = d | s: estampar */
+    GOL_BLEND_XOR,    /* d = d ^ s: invertir */
+    GOL_BLEND_AND     /* d = d & s: enmascarar */
+} GolBlend;
+
+/*
+ * Regiones: el rectangulo de w x h celdas con esquina en (x, y). En el
+ * formato de bytes la celda (x + i, y + j) es buf[j * stride + i] (0 o
+ * 1); en el bitmap es el bit i % 8 (0 = menos significativo) de
+ * buf[j * stride + i / 8]. Lo que cae fuera del grid se lee como muerto
+ * y se ignora al escribir.
+ */
+GOL_API void gol_read_region(const GolGrid *g, int x, int y, int w, int h,
+                             unsigned char *dst, size_t stride);
+GOL_API void gol_write_region(GolGrid *g, int x, int y, int w, int h,
+                              const unsigned char *src, size_t stride, GolBlend blend);
+GOL_API void gol_read_bits(const GolGrid *g, int x, int y, int w, int h,
+                           unsigned char *dst, size_t stride);
+GOL_API void gol_write_bits(GolGrid *g, int x, int y, int w, int h,
+                            const unsigned char *src, size_t stride, GolBlend blend);
+
+/*
+ * gol_population — Celdas vivas.
+ */
+GOL_API uint64_t gol_population(GolGrid *g);
+
+/*
+ * gol_hash — Huella de 64 bits del grid: dos grids con las mismas
+ * celdas vivas dan el mismo valor, en cualquier engine y maquina.
+ */
+GOL_API uint64_t gol_hash(const GolGrid *g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
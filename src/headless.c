@@ -0,0 +1,552 @@
+/*
+ * headless.c — Corredor sin ventana para benchmarks y verificacion.
+ *
+ * Ejecuta la simulacion sin SDL: arma el grid inicial igual que el visor
+ * (mismo generador, misma semilla, mismo patron), avanza N generaciones
+ * y reporta el tiempo y el hash del grid final. Como el grid inicial
+ * depende solo de (semilla, tamanio, densidad) y todos los engines dan
+ * el mismo resultado, dos corridas con los mismos parametros deben
+ * reportar el mismo hash en cualquier maquina: las comparaciones de
+ * rendimiento entre engines o cantidades de threads miden el mismo
+ * trabajo.
+ *
+ * --verify corre cada engine con 1 thread y con --threads threads desde
+ * el mismo estado inicial y falla si algun hash difiere.
+ *
+ * --unbounded simula el plano infinito (universe.h) desde el mismo
+ * estado inicial, con la esquina del grid en (0, 0); el hash es el de
+ * universe_hash, no comparable con el de game_hash.
+ *
+ * --trace FILE registra todas las corridas (trace.h) y escribe el
+ * archivo al salir.
+ *
+ * --metrics-port N sirve el progreso en 127.0.0.1:N (metrics.h) para
+ * corridas largas; los pasos se hacen entonces de a una generacion (o
+ * una pasada de blocked) para publicar el estado entre ellos.
+ *
+ * --procs N reparte el grid en N procesos con una franja de filas cada
+ * uno (domain.h), cada proceso con --threads threads. Con --verify, el
+ * hash se compara con el de un solo proceso con el mismo engine.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime, CLOCK_MONOTONIC */
+
+#include <stdio.h>   /* printf, fprintf, snprintf, stderr */
+#include <stdlib.h>  /* atoi, atol, atof, atexit */
+#include <string.h>  /* strcmp */
+#include <limits.h>  /* INT_MAX */
+#include <time.h>    /* clock_gettime */
+#include "game.h"
+#include "patterns.h"
+#include "pattern_io.h"
+#include "registry.h"
+#include "rng.h"
+#include "universe.h"
+#include "profile.h"
+#include "perfcount.h"
+#include "trace.h"
+#include "metrics.h"
+#include "domain.h"
+
+/* Semilla por defecto: fija, para que dos corridas sin --seed coincidan */
+#define DEFAULT_SEED 1
+
+/*
+ * RunConfig — Parametros de una corrida, compartidos por --verify.
+ */
+typedef struct {
+    int width;
+    int height;
+    float density;
+    uint64_t seed;
+    const char *pattern_name;
+    const char *pattern_file;
+    const char *pattern_dir;
+    long generations;
+    unsigned alloc;
+    int unbounded;
+    int time_block;
+    int perf;
+    int procs;
+} RunConfig;
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [options]\n", prog);
+    fprintf(stderr, "  --width N        Grid width (default 1024)\n");
+    fprintf(stderr, "  --height N       Grid height (default 1024)\n");
+    fprintf(stderr, "  --pattern NAME   Pattern: random or a registered name (default random)\n");
+    fprintf(stderr, "  --pattern-dir DIR    Register every .cells/.mc file in DIR as a --pattern name\n");
+    fprintf(stderr, "  --pattern-file PATH  Load a .cells or .mc pattern file\n");
+    fprintf(stderr, "  --density F      Random fill density 0.0-1.0 (default 0.3)\n");
+    fprintf(stderr, "  --seed N         Seed for the random fill, decimal or 0x hex (default %d)\n", DEFAULT_SEED);
+    fprintf(stderr, "  --generations N  Generations to run (default 1000)\n");
+    fprintf(stderr, "  --engine NAME    Stepping kernel: scalar, vector, blocked, lut, colsum (default vector)\n");
+    fprintf(stderr, "  --time-block K   Generations per pass of the blocked engine, 1-%d (default %d)\n",
+            GAME_TIME_BLOCK_MAX, GAME_TIME_BLOCK_DEFAULT);
+    fprintf(stderr, "  --threads N      Worker threads (default: all CPUs)\n");
+    fprintf(stderr, "  --large-grid     Allocate grid buffers with mmap\n");
+    fprintf(stderr, "  --huge-pages     Like --large-grid, requesting transparent huge pages\n");
+    fprintf(stderr, "  --byte-cells     Store one byte per cell instead of an int\n");
+    fprintf(stderr, "  --unbounded      Simulate an infinite plane seeded from the grid\n");
+    fprintf(stderr, "  --procs N        Split the grid into row slabs across N processes (Linux)\n");
+    fprintf(stderr, "  --verify         Run every engine with 1 and N threads and compare hashes\n");
+    fprintf(stderr, "  --perf           Report hardware counters per cell (Linux perf_event_open)\n");
+    fprintf(stderr, "  --trace FILE     Write a Chrome trace-event JSON of steps and worker chunks\n");
+    fprintf(stderr, "  --metrics-port N Serve Prometheus text metrics on 127.0.0.1:N\n");
+}
+
+/* Destino de --trace, para finish_trace */
+static const char *trace_path;
+
+/*
+ * finish_trace — Escribe el trace al salir del proceso (atexit), por
+ * cualquiera de los caminos de retorno de main.
+ */
+static void finish_trace(void) {
+    if (!trace_close())
+        fprintf(stderr, "Failed to write trace: %s\n", trace_path);
+}
+
+/*
+ * now_seconds — Reloj monotono en segundos, para medir el tiempo de los
+ * pasos sin que lo afecten ajustes del reloj del sistema.
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/*
+ * setup_grid — Estado inicial con la misma logica que el visor: un
+ * --pattern-file tiene prioridad, "random" llena con la semilla, y
+ * cualquier otro nombre se busca en el registro. A diferencia del visor,
+ * un patron que no se puede cargar es un error: una corrida de benchmark
+ * no debe caer silenciosamente en otro estado inicial.
+ * Retorna 1 en exito, 0 si el patron no pudo cargarse.
+ */
+static int setup_grid(Game *g, const RunConfig *cfg) {
+    int ok = 1;
+    game_clear(g);
+    if (cfg->pattern_file) {
+        int ox = cfg->width / 4, oy = cfg->height / 4;
+        if (pattern_format_from_path(cfg->pattern_file) == PATTERN_FMT_MC) {
+            ox = cfg->width / 2;
+            oy = cfg->height / 2;
+        }
+        pattern_file_origin(cfg->pattern_file, &ox, &oy);
+        ok = pattern_load_file(g, cfg->pattern_file, ox, oy);
+        if (!ok) fprintf(stderr, "Failed to load pattern file: %s\n", cfg->pattern_file);
+    } else if (strcmp(cfg->pattern_name, "random") == 0) {
+        game_randomize(g, cfg->density, cfg->seed);
+    } else {
+        PatternRegistry *registry = registry_create();
+        const PatternEntry *entry = NULL;
+        if (registry && cfg->pattern_dir && registry_add_dir(registry, cfg->pattern_dir) < 0)
+            fprintf(stderr, "Cannot open pattern directory: %s\n", cfg->pattern_dir);
+        if (registry) entry = registry_find(registry, cfg->pattern_name);
+        if (entry) {
+            int64_t px = cfg->width / 4, py = cfg->height / 4;
+            if (!entry->builtin) {
+                px = ((int64_t)cfg->width - entry->width) / 2;
+                py = ((int64_t)cfg->height - entry->height) / 2;
+            }
+            ok = registry_load(registry, entry, g, px, py);
+            if (!ok) fprintf(stderr, "Failed to read pattern: %s\n", cfg->pattern_name);
+        } else {
+            fprintf(stderr, "Unknown pattern: %s\n", cfg->pattern_name);
+            ok = 0;
+        }
+        registry_destroy(registry);
+    }
+    return ok;
+}
+
+/*
+ * block_label — Sufijo " k=N" con las generaciones por pasada de g, en
+ * un buffer estatico (se usa una vez por linea impresa).
+ */
+static const char *block_label(const Game *g) {
+    static char label[32];
+    snprintf(label, sizeof(label), " k=%d", g->time_block);
+    return label;
+}
+
+/*
+ * print_perf — Linea de contadores de hardware por celda calculada
+ * (celdas x generaciones) e IPC; "n/a" para los eventos que no pudieron
+ * abrirse.
+ */
+static void print_perf(const PerfSample *s, double cells) {
+    int e;
+    printf("perf:");
+    for (e = 0; e < PERF_EVENT_COUNT; e++) {
+        if (s->available[e])
+            printf(" %s/cell=%.4f", perfcount_name((PerfEvent)e), (double)s->values[e] / cells);
+        else
+            printf(" %s/cell=n/a", perfcount_name((PerfEvent)e));
+    }
+    if (s->available[PERF_CYCLES] && s->available[PERF_INSTRUCTIONS] && s->values[PERF_CYCLES])
+        printf(" ipc=%.2f", (double)s->values[PERF_INSTRUCTIONS] / (double)s->values[PERF_CYCLES]);
+    printf("\n");
+}
+
+/*
+ * run_once — Crea un Game con el engine y los threads dados, arma el
+ * estado inicial y avanza cfg->generations generaciones. Solo se mide
+ * el tiempo de los pasos (y, con --perf, los contadores de hardware,
+ * abiertos antes de crear los workers para que los hereden). Escribe el
+ * hash final en *hash.
+ * Retorna 1 en exito, 0 si falla la alocacion o la carga del patron.
+ */
+static int run_once(const RunConfig *cfg, GameEngine engine, int threads, uint64_t *hash) {
+    static int perf_warned;
+    Game *g = game_create_ex(cfg->width, cfg->height, cfg->alloc);
+    PerfCounters *pc = NULL;
+    PerfSample sample;
+    GameStats stats;
+    double t0, elapsed;
+    long left;
+    int batch, max_batch;
+    if (!g) {
+        fprintf(stderr, "Failed to create game\n");
+        return 0;
+    }
+    if (cfg->perf && !(pc = perfcount_open()) && !perf_warned) {
+        fprintf(stderr, "Hardware counters unavailable (needs Linux, a PMU and perf_event_paranoid <= 2)\n");
+        perf_warned = 1;
+    }
+    if (!game_set_threads(g, threads))
+        fprintf(stderr, "Failed to start worker threads, running single-threaded\n");
+    game_set_engine(g, engine);
+    game_set_time_block(g, cfg->time_block);
+    if (!setup_grid(g, cfg)) {
+        perfcount_close(pc);
+        game_destroy(g);
+        return 0;
+    }
+
+    PROFILE_RESET();
+    if (pc) perfcount_start(pc);
+    t0 = now_seconds();
+    max_batch = !metrics_enabled ? INT_MAX : engine == GAME_ENGINE_BLOCKED ? g->time_block : 1;
+    for (left = cfg->generations; left > 0; left -= batch) {
+        METRICS_STEP_BEGIN(t_step);
+        batch = max_batch < left ? max_batch : (int)left;
+        game_step_n(g, batch);
+        METRICS_STEP_END(t_step, batch);
+        if (metrics_publish_due()) {
+            game_stats(g, &stats);
+            metrics_publish((uint64_t)(cfg->generations - left + batch), stats.population,
+                            game_memory(g), -1);
+        }
+    }
+    elapsed = now_seconds() - t0;
+    if (pc) perfcount_stop(pc, &sample);
+
+    *hash = game_hash(g);
+    game_stats(g, &stats);
+    printf("engine=%s%s cells=%s threads=%d size=%dx%d seed=%llu generations=%ld "
+           "population=%llu hash=%016llx time=%.3fs rate=%.1f Mcells/s\n",
+           game_engine_name(engine), engine == GAME_ENGINE_BLOCKED ? block_label(g) : "",
+           g->cells8 ? "byte" : "int",
+           pool_threads(g->pool), cfg->width, cfg->height,
+           (unsigned long long)cfg->seed, cfg->generations,
+           (unsigned long long)stats.population, (unsigned long long)*hash,
+           elapsed,
+           elapsed > 0 ? (double)cfg->width * cfg->height * cfg->generations / elapsed / 1e6 : 0.0);
+    if (pc && cfg->generations > 0)
+        print_perf(&sample, (double)cfg->width * cfg->height * cfg->generations);
+    PROFILE_REPORT(stdout);
+    perfcount_close(pc);
+    game_destroy(g);
+    return 1;
+}
+
+/*
+ * run_unbounded — Como run_once, pero copia el estado inicial a un
+ * Universe y avanza el plano infinito. Reporta ademas la poblacion y los
+ * tiles alocados, que miden el area activa, y los contadores del pool
+ * de tiles.
+ */
+static int run_unbounded(const RunConfig *cfg, int threads, uint64_t *hash) {
+    Game *g = game_create_ex(cfg->width, cfg->height, cfg->alloc);
+    Universe *u = universe_create();
+    SlabStats stats;
+    double t0, elapsed;
+    long gen;
+    int ok = g && u && setup_grid(g, cfg) && universe_from_game(u, g, 0, 0);
+    game_destroy(g);
+    if (!ok) {
+        fprintf(stderr, "Failed to create unbounded universe\n");
+        universe_destroy(u);
+        return 0;
+    }
+    if (!universe_set_threads(u, threads))
+        fprintf(stderr, "Failed to start worker threads, running single-threaded\n");
+
+    PROFILE_RESET();
+    t0 = now_seconds();
+    for (gen = 0; gen < cfg->generations && ok; gen++) {
+        METRICS_STEP_BEGIN(t_step);
+        ok = universe_step(u);
+        METRICS_STEP_END(t_step, 1);
+        if (metrics_publish_due())
+            metrics_publish((uint64_t)gen + 1, universe_population(u), universe_memory(u),
+                            (long)universe_tile_count(u));
+    }
+    elapsed = now_seconds() - t0;
+    if (!ok) {
+        fprintf(stderr, "Out of memory at generation %ld\n", gen);
+        universe_destroy(u);
+        return 0;
+    }
+
+    *hash = universe_hash(u);
+    universe_pool_stats(u, &stats);
+    printf("engine=unbounded threads=%d seed=%llu generations=%ld population=%llu "
+           "tiles=%zu hash=%016llx time=%.3fs\n",
+           threads, (unsigned long long)cfg->seed, cfg->generations,
+           (unsigned long long)universe_population(u), universe_tile_count(u),
+           (unsigned long long)*hash, elapsed);
+    printf("tile pool: hits=%llu misses=%llu high_water=%llu slabs=%llu\n",
+           (unsigned long long)stats.hits, (unsigned long long)stats.misses,
+           (unsigned long long)stats.high_water, (unsigned long long)stats.slabs);
+    PROFILE_REPORT(stdout);
+    universe_destroy(u);
+    return 1;
+}
+
+/*
+ * run_procs — Como run_once, pero avanza el grid repartido en
+ * cfg->procs procesos (domain.h), cada uno con threads threads. El
+ * estado inicial se arma en un Game de este proceso, se copia al grid
+ * compartido, y el resultado vuelve a ese Game para el hash y las
+ * estadisticas. El tiempo es el de los pasos, sin crear los procesos.
+ */
+static int run_procs(const RunConfig *cfg, GameEngine engine, int threads, uint64_t *hash) {
+    Game *g = game_create_ex(cfg->width, cfg->height, cfg->alloc);
+    Domain *d = domain_create(cfg->width, cfg->height, cfg->procs);
+    DomainConfig dc;
+    GameStats stats;
+    double elapsed;
+    if (!g || !d) {
+        fprintf(stderr, "Failed to create %s\n", g ? "shared memory domain" : "game");
+        domain_destroy(d);
+        game_destroy(g);
+        return 0;
+    }
+    if (!setup_grid(g, cfg)) {
+        domain_destroy(d);
+        game_destroy(g);
+        return 0;
+    }
+    game_read_region(g, 0, 0, cfg->width, cfg->height, domain_grid(d), (size_t)cfg->width);
+
+    dc.generations = cfg->generations;
+    dc.engine = engine;
+    dc.alloc = cfg->alloc;
+    dc.threads = threads;
+    if (!domain_run(d, &dc)) {
+        fprintf(stderr, "A slab process failed\n");
+        domain_destroy(d);
+        game_destroy(g);
+        return 0;
+    }
+    game_write_region(g, 0, 0, cfg->width, cfg->height, domain_grid(d), (size_t)cfg->width,
+                      GAME_BLEND_COPY);
+    elapsed = domain_elapsed(d);
+
+    *hash = game_hash(g);
+    game_stats(g, &stats);
+    printf("engine=%s cells=%s procs=%d threads=%d size=%dx%d seed=%llu generations=%ld "
+           "population=%llu hash=%016llx time=%.3fs rate=%.1f Mcells/s\n",
+           game_engine_name(engine), g->cells8 ? "byte" : "int",
+           domain_procs(d), threads, cfg->width, cfg->height,
+           (unsigned long long)cfg->seed, cfg->generations,
+           (unsigned long long)stats.population, (unsigned long long)*hash,
+           elapsed,
+           elapsed > 0 ? (double)cfg->width * cfg->height * cfg->generations / elapsed / 1e6 : 0.0);
+    domain_destroy(d);
+    game_destroy(g);
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    RunConfig cfg;
+    GameEngine engine = GAME_ENGINE_VECTOR;
+    int threads = parallel_cpu_count();
+    int verify = 0;
+    int metrics_port = 0;
+    int i;
+
+    cfg.width = 1024;
+    cfg.height = 1024;
+    cfg.density = 0.3f;
+    cfg.seed = DEFAULT_SEED;
+    cfg.pattern_name = "random";
+    cfg.pattern_file = NULL;
+    cfg.pattern_dir = NULL;
+    cfg.generations = 1000;
+    cfg.alloc = 0;
+    cfg.unbounded = 0;
+    cfg.time_block = GAME_TIME_BLOCK_DEFAULT;
+    cfg.perf = 0;
+    cfg.procs = 0;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            cfg.width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            cfg.height = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--pattern") == 0 && i + 1 < argc) {
+            cfg.pattern_name = argv[++i];
+        } else if (strcmp(argv[i], "--pattern-dir") == 0 && i + 1 < argc) {
+            cfg.pattern_dir = argv[++i];
+        } else if (strcmp(argv[i], "--pattern-file") == 0 && i + 1 < argc) {
+            cfg.pattern_file = argv[++i];
+        } else if (strcmp(argv[i], "--density") == 0 && i + 1 < argc) {
+            cfg.density = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!rng_parse_seed(argv[++i], &cfg.seed)) {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--generations") == 0 && i + 1 < argc) {
+            cfg.generations = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            if (!game_engine_from_name(argv[++i], &engine)) {
+                fprintf(stderr, "Unknown engine: %s\n", argv[i]);
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time-block") == 0 && i + 1 < argc) {
+            cfg.time_block = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--large-grid") == 0) {
+            cfg.alloc |= GAME_ALLOC_MMAP;
+        } else if (strcmp(argv[i], "--huge-pages") == 0) {
+            cfg.alloc |= GAME_ALLOC_MMAP | GAME_ALLOC_HUGEPAGES;
+        } else if (strcmp(argv[i], "--byte-cells") == 0) {
+            cfg.alloc |= GAME_CELLS_BYTES;
+        } else if (strcmp(argv[i], "--unbounded") == 0) {
+            cfg.unbounded = 1;
+        } else if (strcmp(argv[i], "--procs") == 0 && i + 1 < argc) {
+            cfg.procs = atoi(argv[++i]);
+            if (cfg.procs < 1) {
+                fprintf(stderr, "Invalid process count: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--perf") == 0) {
+            cfg.perf = 1;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc) {
+            metrics_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--verify") == 0) {
+            verify = 1;
+        } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (cfg.width < 1 || cfg.height < 1 || cfg.generations < 0) {
+        fprintf(stderr, "Width and height must be positive and generations non-negative\n");
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+    if (cfg.procs) {
+        /* fork solo duplica el thread que llama: nada de threads de fondo */
+        if (cfg.unbounded || cfg.perf || metrics_port) {
+            fprintf(stderr, "--procs cannot be combined with --unbounded, --perf or --metrics-port\n");
+            return 1;
+        }
+        if (!domain_supported()) {
+            fprintf(stderr, "--procs needs Linux (futex)\n");
+            return 1;
+        }
+        if (cfg.procs > cfg.height) cfg.procs = cfg.height;
+    }
+    if (trace_path) {
+        if (!trace_open(trace_path)) {
+            fprintf(stderr, "Failed to allocate trace buffer\n");
+            return 1;
+        }
+        atexit(finish_trace);
+    }
+    if (metrics_port) {
+        if (!metrics_start(metrics_port)) {
+            fprintf(stderr, "Failed to serve metrics on 127.0.0.1:%d\n", metrics_port);
+            return 1;
+        }
+        atexit(metrics_stop);
+    }
+
+    if (cfg.unbounded) {
+        uint64_t hash, reference;
+        if (!run_unbounded(&cfg, verify ? 1 : threads, &reference)) return 1;
+        if (!verify || threads == 1) return 0;
+        if (!run_unbounded(&cfg, threads, &hash)) return 1;
+        if (hash != reference) {
+            fprintf(stderr, "Verify FAILED: %d threads differ from 1 thread\n", threads);
+            return 1;
+        }
+        printf("Verify OK: thread counts agree on hash %016llx\n", (unsigned long long)reference);
+        return 0;
+    }
+
+    if (cfg.procs) {
+        uint64_t hash, reference;
+        if (!run_procs(&cfg, engine, threads, &hash)) return 1;
+        if (!verify) return 0;
+        if (!run_once(&cfg, engine, threads, &reference)) return 1;
+        if (hash != reference) {
+            fprintf(stderr, "Verify FAILED: %d processes differ from a single process\n", cfg.procs);
+            return 1;
+        }
+        printf("Verify OK: processes agree on hash %016llx\n", (unsigned long long)reference);
+        return 0;
+    }
+
+    if (!verify) {
+        uint64_t hash;
+        return run_once(&cfg, engine, threads, &hash) ? 0 : 1;
+    }
+
+    /*
+     * Verificacion cruzada: la primera corrida (scalar, 1 thread) es la
+     * referencia. Se comparan todos los engines con 1 thread y, si se
+     * pidio mas de uno, tambien con threads threads. Con --byte-cells la
+     * referencia es scalar sobre celdas int, y todas las corridas de
+     * bytes se comparan con ella.
+     */
+    {
+        uint64_t reference = 0, hash;
+        int e, pass, mismatches = 0;
+        int bytes = (cfg.alloc & GAME_CELLS_BYTES) != 0;
+        if (bytes) {
+            RunConfig ints = cfg;
+            ints.alloc &= ~GAME_CELLS_BYTES;
+            if (!run_once(&ints, GAME_ENGINE_SCALAR, 1, &reference)) return 1;
+        }
+        for (pass = 0; pass < (threads > 1 ? 2 : 1); pass++) {
+            for (e = 0; e < GAME_ENGINE_COUNT; e++) {
+                if (!run_once(&cfg, (GameEngine)e, pass ? threads : 1, &hash)) return 1;
+                if (pass == 0 && e == 0 && !bytes) reference = hash;
+                else if (hash != reference) mismatches++;
+            }
+        }
+        if (mismatches) {
+            fprintf(stderr, "Verify FAILED: %d run(s) differ from scalar/1 thread\n", mismatches);
+            return 1;
+        }
+        printf("Verify OK: all engines agree on hash %016llx\n", (unsigned long long)reference);
+    }
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * history.c — Keyframes y deltas XOR comprimidos de history.h.
+ *
+ * Formato de una entrada: el bitmap del grid (game_read_bits, filas de
+ * stride bytes) se ve como un arreglo de palabras de 64 bits. Para un
+ * delta se codifica el XOR con el bitmap anterior; para un keyframe el
+ * XOR con un bitmap vacio, es decir el bitmap mismo. La codificacion es
+ * una secuencia de tramos:
+ *     varint ceros, varint n, n palabras literales
+ * donde "ceros" es la cantidad de palabras nulas que se saltean y las n
+ * palabras siguientes son todas distintas de cero. Los ceros del final
+ * no se escriben. Los varint son LEB128 (7 bits por byte).
+ *
+ * Las entradas viven en un ring buffer que crece al doble cuando se
+ * llena; descartar el grupo mas antiguo solo avanza el inicio.
+ */
+
+#include <stdlib.h>  /* malloc, calloc, free */
+#include <string.h>  /* memcpy, memset */
+#include <stdint.h>  /* uint64_t */
+#include <limits.h>  /* LONG_MAX, INT_MAX */
+#include "history.h"
+
+/* Entradas iniciales del ring buffer */
+#define INITIAL_ENTRIES 64
+
+typedef struct {
+    long generation;
+    int key;               /* 1 = keyframe, 0 = delta */
+    size_t size;           /* Bytes de data */
+    unsigned char *data;   /* Tramos codificados */
+} HistEntry;
+
+struct History {
+    int width, height;
+    size_t stride;         /* Bytes por fila del bitmap */
+    size_t words;          /* Palabras de 64 bits del bitmap */
+    size_t budget;         /* Tope de bytes, buffers incluidos (history_memory) */
+
+    HistEntry *ring;
+    size_t cap, head, count;
+    size_t bytes;          /* Suma de los size de las entradas */
+    int keys;              /* Keyframes en el ring */
+    int since_key;         /* Entradas desde el ultimo keyframe, inclusive */
+    size_t since_key_bytes;  /* Bytes de los deltas desde el ultimo keyframe */
+
+    uint64_t *cur;         /* Bitmap de la entrada mas reciente */
+    uint64_t *tmp;         /* Bitmap del estado a registrar */
+    unsigned char *enc;    /* Buffer de codificacion (peor caso) */
+    size_t enc_cap;
+};
+
+static HistEntry *entry(const History *h, size_t i) {
+    return &h->ring[(h->head + i) % h->cap];
+}
+
+static size_t put_varint(unsigned char *p, size_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        p[n++] = (unsigned char)(v | 0x80);
+        v >>= 7;
+    }
+    p[n++] = (unsigned char)v;
+    return n;
+}
+
+static size_t get_varint(const unsigned char **p) {
+    size_t v = 0;
+    int shift = 0;
+    unsigned char b;
+    do {
+        b = *(*p)++;
+        v |= (size_t)(b & 0x7f) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return v;
+}
+
+/*
+ * encode_xor — Codifica a ^ b (b == NULL: solo a) en out. Retorna los
+ * bytes escritos, a lo sumo el enc_cap calculado en history_create.
+ */
+static size_t encode_xor(const uint64_t *a, const uint64_t *b, size_t n, unsigned char *out) {
+    size_t i = 0, len = 0;
+    while (i < n) {
+        size_t start = i, lit;
+        while (i < n && (a[i] ^ (b ? b[i] : 0)) == 0) i++;
+        if (i == n) break;
+        lit = i;
+        while (i < n && (a[i] ^ (b ? b[i] : 0)) != 0) i++;
+        len += put_varint(out + len, lit - start);
+        len += put_varint(out + len, i - lit);
+        for (; lit < i; lit++) {
+            uint64_t w = a[lit] ^ (b ? b[lit] : 0);
+            memcpy(out + len, &w, sizeof w);
+            len += sizeof w;
+        }
+    }
+    return len;
+}
+
+/*
+ * apply_xor — Aplica los tramos de una entrada sobre bits con XOR.
+ */
+static void apply_xor(uint64_t *bits, const unsigned char *p, size_t size) {
+    const unsigned char *end = p + size;
+    size_t i = 0;
+    while (p < end) {
+        size_t n;
+        i += get_varint(&p);
+        n = get_varint(&p);
+        for (; n > 0; n--, i++) {
+            uint64_t w;
+            memcpy(&w, p, sizeof w);
+            p += sizeof w;
+            bits[i] ^= w;
+        }
+    }
+}
+
+/*
+ * fixed_bytes — Memoria que el historial usa sin ninguna entrada: los
+ * dos bitmaps, el buffer de codificacion en el peor caso (todas las
+ * palabras mas un encabezado de dos varints por cada dos) y el ring
+ * inicial.
+ */
+static size_t fixed_bytes(size_t words, size_t *enc_cap) {
+    *enc_cap = words * 8 + (words / 2 + 1) * 2 * 10;
+    return 2 * words * sizeof(uint64_t) + *enc_cap + INITIAL_ENTRIES * sizeof(HistEntry);
+}
+
+static size_t bitmap_words(int width, int height) {
+    return ((((size_t)width + 7) / 8) * (size_t)height + 7) / 8;
+}
+
+size_t history_min_budget(int width, int height) {
+    size_t enc_cap, words = bitmap_words(width, height);
+    /* Ademas de los buffers, al menos un keyframe sin comprimir */
+    return fixed_bytes(words, &enc_cap) + words * 8;
+}
+
+History *history_create(int width, int height, size_t budget) {
+    History *h;
+    if (width <= 0 || height <= 0 || budget < history_min_budget(width, height)) return NULL;
+    h = calloc(1, sizeof(History));
+    if (!h) return NULL;
+    h->width = width;
+    h->height = height;
+    h->stride = ((size_t)width + 7) / 8;
+    h->words = bitmap_words(width, height);
+    h->budget = budget;
+    fixed_bytes(h->words, &h->enc_cap);
+    h->cur = calloc(h->words, sizeof(uint64_t));
+    h->tmp = calloc(h->words, sizeof(uint64_t));
+    h->enc = malloc(h->enc_cap);
+    if (!h->cur || !h->tmp || !h->enc) {
+        history_destroy(h);
+        return NULL;
+    }
+    return h;
+}
+
+/*
+ * drop_oldest — Libera la entrada mas antigua del ring.
+ */
+static void drop_oldest(History *h) {
+    HistEntry *e = entry(h, 0);
+    h->bytes -= e->size;
+    h->keys -= e->key;
+    free(e->data);
+    h->head = (h->head + 1) % h->cap;
+    h->count--;
+}
+
+/*
+ * drop_newest — Libera la entrada mas reciente del ring.
+ */
+static void drop_newest(History *h) {
+    HistEntry *e = entry(h, h->count - 1);
+    h->bytes -= e->size;
+    h->keys -= e->key;
+    free(e->data);
+    h->count--;
+}
+
+static void history_clear(History *h) {
+    while (h->count > 0) drop_oldest(h);
+    h->since_key = 0;
+    h->since_key_bytes = 0;
+}
+
+void history_destroy(History *h) {
+    if (!h) return;
+    if (h->ring) history_clear(h);
+    free(h->ring);
+    free(h->cur);
+    free(h->tmp);
+    free(h->enc);
+    free(h);
+}
+
+/*
+ * push_entry — Agrega e al final del ring, duplicando la capacidad si
+ * esta lleno. Retorna 0 si falla la alocacion.
+ */
+static int push_entry(History *h, const HistEntry *e) {
+    if (h->count == h->cap) {
+        size_t cap = h->cap ? h->cap * 2 : INITIAL_ENTRIES, i;
+        HistEntry *ring = malloc(cap * sizeof(HistEntry));
+        if (!ring) return 0;
+        for (i = 0; i < h->count; i++) ring[i] = *entry(h, i);
+        free(h->ring);
+        h->ring = ring;
+        h->cap = cap;
+        h->head = 0;
+    }
+    h->ring[(h->head + h->count) % h->cap] = *e;
+    h->count++;
+    return 1;
+}
+
+int history_record(History *h, const Game *g, long generation) {
+    HistEntry e;
+    uint64_t *swap;
+
+    game_read_bits(g, 0, 0, h->width, h->height, (unsigned char *)h->tmp, h->stride);
+
+    /*
+     * Keyframe nuevo si no hay ninguno, si el grupo ya es largo o pesa
+     * mas que un grid sin comprimir, o si el unico grupo esta por superar
+     * el presupuesto (sin un segundo keyframe no podria descartarse).
+     */
+    e.key = h->count == 0 || h->since_key >= HISTORY_KEY_INTERVAL ||
+            h->since_key_bytes > h->words * 8 ||
+            (h->keys == 1 && history_memory(h) + h->words * 8 > h->budget);
+    e.generation = generation;
+    e.size = encode_xor(h->tmp, e.key ? NULL : h->cur, h->words, h->enc);
+    e.data = malloc(e.size ? e.size : 1);
+    if (!e.data || !push_entry(h, &e)) {
+        free(e.data);
+        history_clear(h);
+        return 0;
+    }
+    memcpy(e.data, h->enc, e.size);
+
+    swap = h->cur;
+    h->cur = h->tmp;
+    h->tmp = swap;
+    h->bytes += e.size;
+    h->keys += e.key;
+    h->since_key = e.key ? 1 : h->since_key + 1;
+    h->since_key_bytes = e.key ? 0 : h->since_key_bytes + e.size;
+
+    while (history_memory(h) > h->budget && h->keys > 1) {
+        do drop_oldest(h); while (!entry(h, 0)->key);
+    }
+    return 1;
+}
+
+long history_rewind(History *h, Game *g, long target) {
+    size_t i, k, j;
+    long prev = LONG_MAX, gen;
+
+    /* Entrada a restaurar: la primera hacia atras con generacion <= target */
+    for (i = h->count; i > 0; i--) {
+        gen = entry(h, i - 1)->generation;
+        if (gen > prev || gen <= target) break;  /* gen > prev: corrida previa */
+        prev = gen;
+    }
+    if (i == 0) return -1;
+    i--;
+    gen = entry(h, i)->generation;
+
+    /* Descartar el futuro y reconstruir desde el keyframe del grupo */
+    while (h->count > i + 1) drop_newest(h);
+    for (k = i; !entry(h, k)->key; k--)
+        ;
+    memset(h->cur, 0, h->words * sizeof(uint64_t));
+    h->since_key_bytes = 0;
+    for (j = k; j <= i; j++) {
+        const HistEntry *e = entry(h, j);
+        apply_xor(h->cur, e->data, e->size);
+        if (j > k) h->since_key_bytes += e->size;
+    }
+    h->since_key = (int)(i - k + 1);
+    game_write_bits(g, 0, 0, h->width, h->height, (const unsigned char *)h->cur, h->stride,
+                    GAME_BLEND_COPY);
+
+    /* Entre dos entradas registradas: recalcular las que faltan */
+    if (gen >= target) return gen;
+    while (gen < target) {
+        int gens = target - gen < INT_MAX ? (int)(target - gen) : INT_MAX;
+        game_step_n(g, gens);
+        gen += gens;
+    }
+    return gen;
+}
+
+int history_count(const History *h) {
+    return (int)h->count;
+}
+
+size_t history_memory(const History *h) {
+    return h->bytes + h->cap * sizeof(HistEntry) + 2 * h->words * sizeof(uint64_t) + h->enc_cap;
+}
@@ -0,0 +1,90 @@
+/*
+ * history.h — Historial de generaciones para volver atras en el visor.
+ *
+ * Cada estado registrado es una entrada de una linea de tiempo:
+ *   - Keyframe: el grid completo como bitmap (un bit por celda).
+ *   - Delta: el XOR del bitmap con el de la entrada anterior.
+ * Ambos se guardan comprimidos en palabras de 64 bits: solo las palabras
+ * distintas de cero, precedidas por la cantidad de palabras en cero que
+ * se saltean. Un delta entre dos generaciones cercanas ocupa una
+ * fraccion del grid; un keyframe de un grid poco poblado tambien.
+ *
+ * Para reconstruir la entrada i se decodifica el keyframe anterior mas
+ * cercano y se aplican los deltas hasta i. Cada HISTORY_KEY_INTERVAL
+ * entradas (o antes, si los deltas acumulados ya pesan mas que el grid
+ * sin comprimir) se guarda un keyframe nuevo, lo que acota ese replay.
+ *
+ * La memoria total (entradas, ring y buffers de trabajo, lo que cuenta
+ * history_memory) se limita a un presupuesto: al superarlo se descarta
+ * el keyframe mas antiguo junto con sus deltas. Como minimo se conserva
+ * el grupo del keyframe mas reciente.
+ *
+ * Registrar un estado lee y codifica el grid completo, O(width x
+ * height): el visor solo mantiene historial si se pide con --history-mb.
+ *
+ * La linea de tiempo no exige generaciones crecientes: tras regenerar
+ * el grid (R) la generacion vuelve a 0 y las entradas anteriores siguen
+ * disponibles. history_rewind cruza ese limite yendo al ultimo estado
+ * de la corrida anterior.
+ */
+
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>  /* size_t */
+#include "game.h"
+
+/* Entradas maximas entre dos keyframes */
+#define HISTORY_KEY_INTERVAL 32
+
+typedef struct History History;
+
+/*
+ * history_min_budget — Presupuesto minimo de history_create para un grid
+ * de width x height: los buffers de trabajo mas un keyframe completo.
+ */
+size_t history_min_budget(int width, int height);
+
+/*
+ * history_create — Historial vacio para un grid de width x height con
+ * un presupuesto de budget bytes. Retorna NULL si budget es menor que
+ * history_min_budget o si falla la alocacion.
+ */
+History *history_create(int width, int height, size_t budget);
+
+/*
+ * history_destroy — Libera el historial. Acepta NULL.
+ */
+void history_destroy(History *h);
+
+/*
+ * history_record — Agrega el estado actual de g como la entrada mas
+ * reciente, con su numero de generacion. Retorna 0 si falla la
+ * alocacion; el historial queda vacio y sigue siendo usable.
+ */
+int history_record(History *h, const Game *g, long generation);
+
+/*
+ * history_rewind — Vuelve g a la generacion target: restaura la entrada
+ * mas reciente de la corrida actual con generacion <= target y, si esa
+ * entrada es anterior a target, avanza las generaciones que faltan con
+ * game_step_n. Si target es anterior al inicio de la corrida, restaura
+ * el ultimo estado de la corrida previa. Las entradas posteriores a la
+ * restaurada se descartan.
+ * Retorna la generacion en la que quedo g, o -1 si no habia a donde
+ * volver (g no cambia).
+ */
+long history_rewind(History *h, Game *g, long target);
+
+/*
+ * history_count — Entradas guardadas.
+ */
+int history_count(const History *h);
+
+/*
+ * history_memory — Bytes usados por las entradas, el ring y los
+ * buffers; es lo que se compara con el presupuesto.
+ */
+size_t history_memory(const History *h);
+
+#endif
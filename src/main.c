@@ -5,25 +5,80 @@
  *   1. Parsea argumentos de linea de comandos para configurar la simulacion.
  *   2. Inicializa SDL2 y crea las estructuras Game y Renderer.
  *   3. Carga un patron predefinido o genera un grid aleatorio.
- *   4. Ejecuta el loop principal: eventos → simulacion → rendering → delay.
+ *   4. Ejecuta el loop principal: eventos → simulacion → rendering → espera.
  *   5. Limpia todos los recursos al salir.
  *
  * Controles interactivos:
  *   SPACE — Pausar / reanudar la simulacion.
  *   R     — Regenerar el grid con celdas aleatorias.
- *   +/=   — Aumentar la velocidad (FPS target + 2).
- *   -     — Disminuir la velocidad (FPS target - 2).
+ *   H     — Ciclar el modo heatmap: apagado → edad → actividad.
+ *   S     — Guardar el grid en el archivo de snapshot (.cells o .mc).
+ *   +/=   — Aumentar la velocidad (+2 gen/s hasta 60, luego x2).
+ *   -     — Disminuir la velocidad (-2 gen/s bajo 60, si no /2).
+ *   Flechas — Desplazar la ventana sobre el plano (solo --unbounded).
+ *   ,     — Volver una generacion atras (pausa la simulacion).
+ *   [     — Volver REWIND_JUMP generaciones atras (pausa la simulacion).
+ *   .     — Avanzar una generacion (con la simulacion en pausa).
+ *   G     — Ir a una generacion: se escriben los digitos y Enter salta.
+ *           Durante el salto ESC o G lo cancelan.
+ *   Click izquierdo / derecho — Pintar / borrar celdas (arrastrando traza).
+ *   1-6   — Estampar glider, blinker, toad, beacon, pulsar o Gosper gun
+ *           con la esquina en la celda bajo el cursor.
+ *   P     — Imprimir los histogramas de tiempos (build con PROFILE=1).
  *   ESC   — Salir del programa.
  */
 
 #include <stdio.h>   /* fprintf, stderr */
-#include <stdlib.h>  /* atoi, atof, srand, EXIT_SUCCESS, EXIT_FAILURE */
+#include <stdlib.h>  /* atoi, atof, strtol, EXIT_SUCCESS, EXIT_FAILURE */
+#include <limits.h>  /* LONG_MAX */
 #include <string.h>  /* strcmp */
-#include <time.h>    /* time, para semilla de rand */
-#include <SDL.h>     /* SDL_Init, SDL_Quit, SDL_Event, SDL_Delay, etc. */
+#include <time.h>    /* time, para la semilla del generador */
+#include <SDL.h>     /* SDL_Init, SDL_Quit, SDL_Event, etc. */
 #include "game.h"
 #include "render.h"
 #include "patterns.h"
+#include "pattern_io.h"
+#include "registry.h"
+#include "pacing.h"
+#include "rng.h"
+#include "universe.h"
+#include "profile.h"
+#include "trace.h"
+#include "metrics.h"
+#include "history.h"
+#include "edit.h"
+
+/* Velocidad maxima aceptada en generaciones por segundo */
+#define MAX_GENS_PER_SEC 1000000
+
+/* Zoom maximo de las teclas Z y X, en pixeles por celda */
+#define MAX_CELL_SIZE 64
+
+/* Generaciones que retrocede la tecla [ */
+#define REWIND_JUMP 100
+
+/* Computo por frame durante un salto a otra generacion, en ms */
+#define JUMP_SLICE_MS 100
+
+/* Generaciones que se miden con cada engine al elegir el de un salto */
+#define JUMP_PROBE_GENS 16
+
+/* Saltos mas cortos que esto usan el engine actual sin medir */
+#define JUMP_PROBE_MIN 1024
+
+/*
+ * Jump — Salto en curso a otra generacion (tecla G o --start-gen).
+ * Se calcula en tramos de JUMP_SLICE_MS por frame sin dibujar el grid,
+ * asi la ventana sigue respondiendo y el salto puede cancelarse.
+ */
+typedef struct {
+    long target;         /* Generacion destino, -1 = sin salto */
+    long start;          /* Generacion al empezar */
+    int pause_at_end;    /* Pausar al llegar (salto pedido con G) */
+    int probed;          /* Ya se eligio el engine */
+    GameEngine engine;   /* Engine del usuario, se restaura al terminar */
+    Uint64 t0;           /* Inicio del salto, para el ritmo del titulo */
+} Jump;
 
 /*
  * usage — Imprime las opciones de linea de comandos en stderr.
@@ -37,8 +92,193 @@ static void usage(const char *prog) {
     fprintf(stderr, "  --height N      Grid height (default 60)\n");
     fprintf(stderr, "  --cell-size N   Pixel size per cell (default 10)\n");
     fprintf(stderr, "  --pattern NAME  Pattern: random, glider, blinker, toad, beacon, pulsar, gosper (default random)\n");
+    fprintf(stderr, "  --pattern-dir DIR    Register every .cells/.mc file in DIR as a --pattern name\n");
+    fprintf(stderr, "  --pattern-file PATH  Load a .cells or .mc pattern file\n");
+    fprintf(stderr, "  --snapshot PATH Where the S key saves the grid, .cells or .mc (default snapshot.cells)\n");
     fprintf(stderr, "  --density F     Random fill density 0.0-1.0 (default 0.3)\n");
-    fprintf(stderr, "  --fps N         Target FPS (default 10)\n");
+    fprintf(stderr, "  --seed N        Seed for the random fill, decimal or 0x hex (default: current time)\n");
+    fprintf(stderr, "  --fps N         Generations per second, 1-%d (default 10)\n", MAX_GENS_PER_SEC);
+    fprintf(stderr, "  --no-vsync      Pace frames with timers instead of display vsync\n");
+    fprintf(stderr, "  --threads N     Worker threads for parallel operations (default: all CPUs)\n");
+    fprintf(stderr, "  --engine NAME   Stepping kernel: scalar, vector, blocked, lut, colsum (default vector)\n");
+    fprintf(stderr, "  --time-block K  Generations per pass of the blocked engine, 1-%d (default %d)\n",
+            GAME_TIME_BLOCK_MAX, GAME_TIME_BLOCK_DEFAULT);
+    fprintf(stderr, "  --large-grid    Allocate grid buffers with mmap\n");
+    fprintf(stderr, "  --huge-pages    Like --large-grid, requesting transparent huge pages\n");
+    fprintf(stderr, "  --byte-cells    Store one byte per cell instead of an int\n");
+    fprintf(stderr, "  --heatmap MODE  Cell colouring: off, age, activity (default off)\n");
+    fprintf(stderr, "  --unbounded     Simulate an infinite plane; the window is a movable viewport\n");
+    fprintf(stderr, "  --trace FILE    Write a Chrome trace-event JSON of steps, workers and frames\n");
+    fprintf(stderr, "  --metrics-port N  Serve Prometheus text metrics on 127.0.0.1:N\n");
+    fprintf(stderr, "  --history-mb N  Keep N MiB of history for rewinding with , and [ (default 0: off)\n");
+    fprintf(stderr, "  --start-gen N   Jump to generation N before showing the grid\n");
+}
+
+/*
+ * heatmap_from_name — Traduce el argumento de --heatmap a GameTrack.
+ * Retorna 1 si el nombre es valido y escribe el modo en *out; 0 si no.
+ */
+static int heatmap_from_name(const char *name, GameTrack *out) {
+    if (strcmp(name, "off") == 0)      { *out = GAME_TRACK_NONE;     return 1; }
+    if (strcmp(name, "age") == 0)      { *out = GAME_TRACK_AGE;      return 1; }
+    if (strcmp(name, "activity") == 0) { *out = GAME_TRACK_ACTIVITY; return 1; }
+    return 0;
+}
+
+/*
+ * adjust_speed — Nueva velocidad tras pulsar + (dir > 0) o - (dir < 0).
+ *
+ * Bajo 60 gen/s el ajuste es lineal de a 2, como en el control original.
+ * Por encima el ajuste es multiplicativo (x2, /2) para poder llegar a
+ * miles de generaciones por segundo con pocas pulsaciones.
+ */
+static int adjust_speed(int gens_per_sec, int dir) {
+    if (dir > 0) {
+        gens_per_sec = gens_per_sec < 60 ? gens_per_sec + 2 : gens_per_sec * 2;
+        if (gens_per_sec > MAX_GENS_PER_SEC) gens_per_sec = MAX_GENS_PER_SEC;
+    } else {
+        gens_per_sec = gens_per_sec <= 60 ? gens_per_sec - 2 : gens_per_sec / 2;
+        if (gens_per_sec < 1) gens_per_sec = 1;
+    }
+    return gens_per_sec;
+}
+
+/*
+ * adjust_zoom — Nuevo tamanio de celda tras pulsar Z (dir > 0) o X
+ * (dir < 0). Bajo 4 px (donde no hay lineas de grid) el paso es de a 1
+ * pixel; por encima, de a un cuarto del tamanio, para que el zoom se
+ * sienta parejo. Queda entre 1 y MAX_CELL_SIZE.
+ */
+static int adjust_zoom(int cell_size, int dir) {
+    int step = cell_size < 4 ? 1 : cell_size / 4;
+    cell_size += dir > 0 ? step : -step;
+    if (cell_size < 1) cell_size = 1;
+    if (cell_size > MAX_CELL_SIZE) cell_size = MAX_CELL_SIZE;
+    return cell_size;
+}
+
+/*
+ * goto_prompt_key — Procesa una tecla mientras se escribe el destino de
+ * G. *value es el numero escrito (-1 = ninguno). Retorna 1 si se
+ * confirmo con Enter, -1 si se cancelo y 0 si el prompt sigue abierto.
+ */
+static int goto_prompt_key(SDL_Keycode key, long *value) {
+    int digit = -1;
+    if (key >= SDLK_0 && key <= SDLK_9) digit = (int)(key - SDLK_0);
+    else if (key >= SDLK_KP_1 && key <= SDLK_KP_9) digit = (int)(key - SDLK_KP_1) + 1;
+    else if (key == SDLK_KP_0) digit = 0;
+    if (digit >= 0) {
+        long v = *value < 0 ? 0 : *value;
+        if (v <= (LONG_MAX - digit) / 10) *value = v * 10 + digit;
+        return 0;
+    }
+    switch (key) {
+        case SDLK_BACKSPACE:
+            *value = *value < 10 ? -1 : *value / 10;
+            return 0;
+        case SDLK_RETURN:
+        case SDLK_KP_ENTER:
+            return *value >= 0 ? 1 : -1;
+        case SDLK_ESCAPE:
+        case SDLK_g:
+            return -1;
+        default:
+            return 0;
+    }
+}
+
+/*
+ * jump_begin — Empieza un salto de generation a target.
+ */
+static void jump_begin(Jump *j, const Game *g, long generation, long target, int pause_at_end) {
+    j->target = target;
+    j->start = generation;
+    j->pause_at_end = pause_at_end;
+    j->probed = 0;
+    j->engine = g->engine;
+    j->t0 = SDL_GetPerformanceCounter();
+}
+
+/*
+ * jump_end — Termina o cancela el salto y restaura el engine del usuario.
+ */
+static void jump_end(Jump *j, Game *g) {
+    game_set_engine(g, j->engine);
+    j->target = -1;
+}
+
+/*
+ * jump_rate — Generaciones por segundo desde el inicio del salto.
+ */
+static double jump_rate(const Jump *j, long generation) {
+    double secs = (double)(SDL_GetPerformanceCounter() - j->t0) /
+                  (double)SDL_GetPerformanceFrequency();
+    return secs > 0.0 ? (double)(generation - j->start) / secs : 0.0;
+}
+
+/*
+ * pick_fastest_engine — Avanza JUMP_PROBE_GENS generaciones con cada
+ * engine (salvo scalar, la referencia) y deja elegido el mas rapido.
+ * Cual gana depende del tamanio del grid, del tipo de celda y de la
+ * maquina, asi que se mide sobre el grid real en lugar de suponerlo.
+ * Todos los engines dan el mismo resultado, por lo que las generaciones
+ * medidas son parte del salto. Retorna cuantas fueron.
+ */
+static long pick_fastest_engine(Game *g) {
+    static const GameEngine candidates[] = {
+        GAME_ENGINE_VECTOR, GAME_ENGINE_BLOCKED, GAME_ENGINE_LUT, GAME_ENGINE_COLSUM
+    };
+    int n = (int)(sizeof(candidates) / sizeof(candidates[0]));
+    GameEngine best = g->engine;
+    Uint64 best_ticks = 0;
+    int c;
+    for (c = 0; c < n; c++) {
+        Uint64 t0, ticks;
+        game_set_engine(g, candidates[c]);
+        t0 = SDL_GetPerformanceCounter();
+        game_step_n(g, JUMP_PROBE_GENS);
+        ticks = SDL_GetPerformanceCounter() - t0;
+        if (c == 0 || ticks < best_ticks) {
+            best = candidates[c];
+            best_ticks = ticks;
+        }
+    }
+    game_set_engine(g, best);
+    return (long)n * JUMP_PROBE_GENS;
+}
+
+/*
+ * jump_run — Avanza el salto durante JUMP_SLICE_MS como maximo. En el
+ * grid con bordes las generaciones se calculan en pasadas de time_block
+ * (varias por pasada con blocked). Retorna 1 si el salto sigue, 0 si
+ * llego a target y -1 si el plano infinito no pudo crecer.
+ */
+static int jump_run(Jump *j, Game *g, Universe *u, long *generation) {
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    Uint64 slice = SDL_GetPerformanceFrequency() * JUMP_SLICE_MS / 1000;
+
+    if (!u && !j->probed && j->target - *generation >= JUMP_PROBE_MIN) {
+        long probed;
+        METRICS_STEP_BEGIN(t_probe);
+        probed = pick_fastest_engine(g);
+        METRICS_STEP_END(t_probe, (int)probed);
+        *generation += probed;
+        j->probed = 1;
+    }
+    while (*generation < j->target && SDL_GetPerformanceCounter() - t0 < slice) {
+        long left = j->target - *generation;
+        int batch = 1;
+        METRICS_STEP_BEGIN(t_step);
+        if (u) {
+            if (!universe_step(u)) return -1;
+        } else {
+            batch = left < g->time_block ? (int)left : g->time_block;
+            game_step_n(g, batch);
+        }
+        METRICS_STEP_END(t_step, batch);
+        *generation += batch;
+    }
+    return *generation < j->target;
 }
 
 /*
@@ -46,11 +286,11 @@ static void usage(const char *prog) {
  *
  * Flujo de ejecucion:
  *   1. Parseo de argumentos con un loop sobre argv.
- *   2. Inicializacion de la semilla aleatoria con time(NULL).
+ *   2. Semilla aleatoria: --seed o, por defecto, time(NULL).
  *   3. Inicializacion de SDL2 (solo subsistema de video).
  *   4. Creacion del Game (logica) y Renderer (grafico).
  *   5. Carga del patron inicial o randomizacion.
- *   6. Loop principal con control de FPS por frame timing.
+ *   6. Loop principal con control de ritmo por timers de alta resolucion.
  *   7. Cleanup de recursos en orden inverso a la creacion.
  */
 int main(int argc, char *argv[]) {
@@ -59,8 +299,24 @@ int main(int argc, char *argv[]) {
     int grid_h = 60;           /* Alto del grid en celdas */
     int cell_size = 10;        /* Pixeles por celda */
     const char *pattern_name = "random";  /* Patron inicial */
+    const char *pattern_file = NULL;      /* Archivo de patron (.cells/.mc) */
+    const char *pattern_dir = NULL;       /* Biblioteca de patrones indexada */
+    const char *snapshot_path = "snapshot.cells";  /* Destino de la tecla S */
     float density = 0.3f;      /* Densidad para randomizacion (30%) */
-    int target_fps = 10;       /* Generaciones por segundo objetivo */
+    int gens_per_sec = 10;     /* Generaciones por segundo objetivo */
+    int vsync = 1;             /* Presentacion sincronizada con el refresco */
+    int threads = parallel_cpu_count();   /* Threads para operaciones paralelas */
+    GameTrack heatmap = GAME_TRACK_NONE;  /* Modo de coloreado heatmap */
+    GameEngine engine = GAME_ENGINE_VECTOR;  /* Kernel de game_step */
+    int time_block = GAME_TIME_BLOCK_DEFAULT; /* Generaciones por pasada (blocked) */
+    uint64_t seed = 0;         /* Semilla del grid aleatorio */
+    int seed_given = 0;        /* 1 si la semilla vino de --seed */
+    unsigned alloc = 0;        /* Flags GAME_ALLOC_* y GAME_CELLS_BYTES */
+    int unbounded = 0;         /* 1: plano infinito, el grid es una ventana */
+    const char *trace_path = NULL;  /* Destino de --trace */
+    int metrics_port = 0;      /* Puerto de --metrics-port, 0 = sin endpoint */
+    int history_mb = 0;        /* Presupuesto del historial en MiB, 0 = sin historial */
+    long start_gen = 0;        /* Generacion inicial de --start-gen */
     int i;
 
     /*
@@ -82,10 +338,65 @@ int main(int argc, char *argv[]) {
             cell_size = atoi(argv[++i]);
         } else if (strcmp(argv[i], "--pattern") == 0 && i + 1 < argc) {
             pattern_name = argv[++i];
+        } else if (strcmp(argv[i], "--pattern-dir") == 0 && i + 1 < argc) {
+            pattern_dir = argv[++i];
+        } else if (strcmp(argv[i], "--pattern-file") == 0 && i + 1 < argc) {
+            pattern_file = argv[++i];
+        } else if (strcmp(argv[i], "--snapshot") == 0 && i + 1 < argc) {
+            snapshot_path = argv[++i];
+            if (pattern_format_from_path(snapshot_path) == PATTERN_FMT_UNKNOWN) {
+                fprintf(stderr, "Snapshot path must end in .cells or .mc: %s\n", snapshot_path);
+                return 1;
+            }
         } else if (strcmp(argv[i], "--density") == 0 && i + 1 < argc) {
             density = (float)atof(argv[++i]);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            if (!rng_parse_seed(argv[++i], &seed)) {
+                fprintf(stderr, "Invalid seed: %s\n", argv[i]);
+                return 1;
+            }
+            seed_given = 1;
         } else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc) {
-            target_fps = atoi(argv[++i]);
+            gens_per_sec = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--time-block") == 0 && i + 1 < argc) {
+            time_block = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {
+            if (!game_engine_from_name(argv[++i], &engine)) {
+                fprintf(stderr, "Unknown engine: %s\n", argv[i]);
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--large-grid") == 0) {
+            alloc |= GAME_ALLOC_MMAP;
+        } else if (strcmp(argv[i], "--huge-pages") == 0) {
+            alloc |= GAME_ALLOC_MMAP | GAME_ALLOC_HUGEPAGES;
+        } else if (strcmp(argv[i], "--byte-cells") == 0) {
+            alloc |= GAME_CELLS_BYTES;
+        } else if (strcmp(argv[i], "--unbounded") == 0) {
+            unbounded = 1;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--metrics-port") == 0 && i + 1 < argc) {
+            metrics_port = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--history-mb") == 0 && i + 1 < argc) {
+            history_mb = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--start-gen") == 0 && i + 1 < argc) {
+            char *end;
+            start_gen = strtol(argv[++i], &end, 10);
+            if (*end != '\0' || start_gen < 0) {
+                fprintf(stderr, "Invalid start generation: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--no-vsync") == 0) {
+            vsync = 0;
+        } else if (strcmp(argv[i], "--heatmap") == 0 && i + 1 < argc) {
+            if (!heatmap_from_name(argv[++i], &heatmap)) {
+                fprintf(stderr, "Unknown heatmap mode: %s\n", argv[i]);
+                usage(argv[0]);
+                return 1;
+            }
         } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
             usage(argv[0]);
             return 0;
@@ -96,17 +407,22 @@ int main(int argc, char *argv[]) {
         }
     }
 
-    /* Clamping del FPS target al rango [1, 60] */
-    if (target_fps < 1) target_fps = 1;
-    if (target_fps > 60) target_fps = 60;
+    /* Clamping de la velocidad al rango [1, MAX_GENS_PER_SEC] */
+    if (gens_per_sec < 1) gens_per_sec = 1;
+    if (gens_per_sec > MAX_GENS_PER_SEC) gens_per_sec = MAX_GENS_PER_SEC;
 
     /*
      * Semilla del generador aleatorio.
-     * time(NULL) retorna los segundos desde epoch, proporcionando
-     * una semilla diferente en cada ejecucion. El cast a unsigned
-     * satisface la firma de srand().
+     * El generador es el de rng.h, no rand(): la semilla, el tamanio y la
+     * densidad determinan el grid por completo, en cualquier maquina. Sin
+     * --seed se usa time(NULL) (segundos desde epoch), y la semilla elegida
+     * se informa para poder repetir la corrida.
      */
-    srand((unsigned)time(NULL));
+    if (!seed_given) {
+        seed = (uint64_t)time(NULL);
+        fprintf(stderr, "Seed: %llu\n", (unsigned long long)seed);
+    }
+    uint64_t reseeds = 0;   /* Regeneraciones con R, derivan semillas nuevas */
 
     /*
      * Inicializacion de SDL2.
@@ -120,15 +436,36 @@ int main(int argc, char *argv[]) {
     }
 
     /* Creacion de la estructura Game con las dimensiones configuradas */
-    Game *game = game_create(grid_w, grid_h);
+    Game *game = game_create_ex(grid_w, grid_h, alloc);
     if (!game) {
         fprintf(stderr, "Failed to create game\n");
         SDL_Quit();
         return 1;
     }
 
+    /* Pool de threads para las operaciones paralelas del Game */
+    if (!game_set_threads(game, threads)) {
+        fprintf(stderr, "Failed to start worker threads, running single-threaded\n");
+    }
+
+    game_set_engine(game, engine);
+    game_set_time_block(game, time_block);
+
+    /*
+     * Buffer heat opcional: solo se aloca si se pidio el heatmap. En modo
+     * --unbounded game_step no se ejecuta, asi que no hay de donde
+     * actualizarlo.
+     */
+    if (unbounded && heatmap != GAME_TRACK_NONE) {
+        fprintf(stderr, "Heatmap is not available with --unbounded, disabling it\n");
+        heatmap = GAME_TRACK_NONE;
+    }
+    if (!game_set_tracking(game, heatmap)) {
+        fprintf(stderr, "Failed to allocate heatmap buffer, disabling it\n");
+    }
+
     /* Creacion de la ventana y renderer SDL2 */
-    Renderer *renderer = renderer_create(grid_w, grid_h, cell_size);
+    Renderer *renderer = renderer_create(grid_w, grid_h, cell_size, vsync);
     if (!renderer) {
         fprintf(stderr, "Failed to create renderer: %s\n", SDL_GetError());
         game_destroy(game);
@@ -140,55 +477,161 @@ int main(int argc, char *argv[]) {
      * Carga del estado inicial.
      *
      * Si el patron es "random", se llena el grid aleatoriamente con
-     * la densidad especificada. De lo contrario, se intenta resolver
-     * el nombre del patron con pattern_from_name. Si el nombre no es
-     * valido, se cae al modo aleatorio con un aviso en stderr.
+     * la densidad especificada. De lo contrario, se resuelve el nombre
+     * en el registro de patrones (predefinidos + --pattern-dir) con una
+     * busqueda O(1). Si el nombre no es valido, se cae al modo aleatorio
+     * con un aviso en stderr.
      *
-     * Los patrones se colocan en grid_w/4, grid_h/4 para centrarlos
-     * aproximadamente en el primer cuadrante, dejando espacio para
-     * que se expandan.
+     * Los patrones predefinidos se colocan en grid_w/4, grid_h/4 para
+     * centrarlos aproximadamente en el primer cuadrante, dejando espacio
+     * para que se expandan. Los de la biblioteca se centran en el grid
+     * usando el bounding box indexado.
+     *
+     * Un --pattern-file tiene prioridad sobre --pattern. Los .cells se
+     * ubican igual que los patrones predefinidos y los .mc ponen su
+     * origen en el centro del grid (solo se expande la parte visible),
+     * salvo que el archivo traiga su origen (los snapshots de S):
+     * entonces vuelve a donde estaba.
      */
-    if (strcmp(pattern_name, "random") == 0) {
-        game_randomize(game, density);
+    if (pattern_file) {
+        int ox = grid_w / 4, oy = grid_h / 4;
+        if (pattern_format_from_path(pattern_file) == PATTERN_FMT_MC) {
+            ox = grid_w / 2;
+            oy = grid_h / 2;
+        }
+        pattern_file_origin(pattern_file, &ox, &oy);
+        int loaded;
+        game_clear(game);
+        PROFILE_START(t_load);
+        loaded = pattern_load_file(game, pattern_file, ox, oy);
+        PROFILE_STOP(PROFILE_IO, t_load);
+        if (!loaded) {
+            fprintf(stderr, "Failed to load pattern file: %s, using random\n", pattern_file);
+            game_randomize(game, density, seed);
+        }
+    } else if (strcmp(pattern_name, "random") == 0) {
+        game_randomize(game, density, seed);
     } else {
-        PatternType pt;
-        if (pattern_from_name(pattern_name, &pt)) {
+        PatternRegistry *registry = registry_create();
+        const PatternEntry *entry = NULL;
+        if (registry && pattern_dir && registry_add_dir(registry, pattern_dir) < 0)
+            fprintf(stderr, "Cannot open pattern directory: %s\n", pattern_dir);
+        if (registry) entry = registry_find(registry, pattern_name);
+        if (entry) {
+            int64_t px = grid_w / 4, py = grid_h / 4;
+            int loaded;
+            if (!entry->builtin) {
+                px = ((int64_t)grid_w - entry->width) / 2;
+                py = ((int64_t)grid_h - entry->height) / 2;
+            }
             game_clear(game);
-            pattern_load(game, pt, grid_w / 4, grid_h / 4);
+            PROFILE_START(t_load);
+            loaded = registry_load(registry, entry, game, px, py);
+            PROFILE_STOP(PROFILE_IO, t_load);
+            if (!loaded) {
+                fprintf(stderr, "Failed to read pattern: %s, using random\n", pattern_name);
+                game_randomize(game, density, seed);
+            }
         } else {
             fprintf(stderr, "Unknown pattern: %s, using random\n", pattern_name);
-            game_randomize(game, density);
+            game_randomize(game, density, seed);
+        }
+        registry_destroy(registry);
+    }
+
+    /*
+     * Plano infinito: el estado inicial armado en el grid se copia al
+     * Universe con la esquina del grid en (0, 0). Desde aqui el Universe
+     * es el estado real y el grid es solo la ventana que se dibuja,
+     * con esquina en (view_x, view_y).
+     */
+    Universe *universe = NULL;
+    int64_t view_x = 0, view_y = 0;
+    if (unbounded) {
+        universe = universe_create();
+        if (!universe || !universe_from_game(universe, game, view_x, view_y)) {
+            fprintf(stderr, "Failed to create unbounded universe\n");
+            universe_destroy(universe);
+            renderer_destroy(renderer);
+            game_destroy(game);
+            SDL_Quit();
+            return 1;
+        }
+        if (!universe_set_threads(universe, threads))
+            fprintf(stderr, "Failed to start worker threads, running single-threaded\n");
+    }
+
+    /*
+     * Historial para volver atras: solo sobre el grid con bordes, donde
+     * el grid es el estado completo. En --unbounded habria que guardar
+     * el plano entero. Es opcional: registrar cada frame recorre el
+     * grid completo.
+     */
+    History *history = NULL;
+    if (history_mb > 0 && !unbounded) {
+        size_t need = history_min_budget(grid_w, grid_h);
+        if (((size_t)history_mb << 20) < need) {
+            fprintf(stderr, "--history-mb %d is too small for this grid (needs at least %zu MiB), "
+                    "rewinding disabled\n", history_mb, (need + (1u << 20) - 1) >> 20);
+        } else if (!(history = history_create(grid_w, grid_h, (size_t)history_mb << 20)) ||
+                   !history_record(history, game, 0)) {
+            fprintf(stderr, "Failed to allocate history, rewinding disabled\n");
+            history_destroy(history);
+            history = NULL;
         }
     }
 
     /* Variables de estado del loop principal */
     int running = 1;        /* Flag de ejecucion: 0 para salir del loop */
     int paused = 0;         /* Flag de pausa: 1 detiene la simulacion */
-    int generation = 0;     /* Contador de generaciones transcurridas */
+    long generation = 0;    /* Contador de generaciones transcurridas */
+    long goto_value = -1;   /* Digitos escritos tras G, -1 = ninguno */
+    int goto_prompt = 0;    /* 1 mientras se escribe el destino de G */
+    Jump jump;              /* Salto en curso (jump.target < 0 = ninguno) */
+    jump.target = -1;
+    int mouse_x = -1, mouse_y = -1;  /* Ultima posicion del mouse en pixeles */
+    int dragging = 0;       /* 1 mientras un boton pinta o borra */
+    EditKind drag_kind = EDIT_PAINT;
+    int64_t drag_x = 0, drag_y = 0;  /* Ultima celda del trazo, en el plano */
+
+    /* Ediciones del mouse y de 1-6, aplicadas entre generaciones */
+    EditQueue *edits = edit_queue_create();
+    if (!edits) fprintf(stderr, "Failed to allocate edit queue, editing disabled\n");
 
     /*
-     * frame_delay: milisegundos por frame para alcanzar el FPS target.
-     * Ejemplo: 10 FPS → 1000/10 = 100ms por frame.
-     * Uint32 es el tipo de SDL para timestamps en milisegundos.
+     * Pacer: separa la velocidad de simulacion (gen/s) de la cadencia de
+     * presentacion, que no supera el refresco del display.
      */
-    Uint32 frame_delay = 1000 / target_fps;
+    Pacer pacer;
+    pacer_init(&pacer, gens_per_sec, renderer->refresh_hz);
+
+    /* Trace de fases: solo el loop principal, desde el primer frame */
+    if (trace_path && !trace_open(trace_path)) {
+        fprintf(stderr, "Failed to allocate trace buffer, tracing disabled\n");
+    }
+    if (metrics_port && !metrics_start(metrics_port)) {
+        fprintf(stderr, "Failed to serve metrics on 127.0.0.1:%d\n", metrics_port);
+    }
+
+    /* --start-gen: el primer frame ya es parte del salto */
+    if (start_gen > 0) jump_begin(&jump, game, generation, start_gen, 0);
 
     /*
      * Loop principal de la aplicacion.
      *
      * Cada iteracion constituye un frame y sigue este pipeline:
-     *   1. Registrar el timestamp de inicio del frame.
-     *   2. Procesar todos los eventos SDL pendientes (input, cierre).
-     *   3. Si no esta en pausa, avanzar la simulacion una generacion.
+     *   1. Procesar todos los eventos SDL pendientes (input, cierre).
+     *   2. Preguntar al pacer cuantas generaciones tocan en este frame
+     *      (0, 1 o varias si la velocidad supera el refresco).
+     *   3. Ejecutarlas, cortando si se agota el presupuesto del frame.
      *   4. Renderizar el estado actual del grid.
-     *   5. Actualizar el HUD con la informacion del estado.
-     *   6. Calcular el tiempo consumido y esperar el restante para
-     *      mantener el FPS target constante.
+     *   5. Actualizar el HUD con la informacion del estado (generacion,
+     *      poblacion y bounding box).
+     *   6. Esperar al proximo frame (o dejar que vsync lo haga).
      */
     while (running) {
-        /* Timestamp de inicio para el control de frame rate */
-        Uint32 frame_start = SDL_GetTicks();
         SDL_Event event;
+        GameStats stats;
 
         /*
          * Procesamiento de eventos SDL.
@@ -197,13 +640,87 @@ int main(int argc, char *argv[]) {
          * Se procesan todos los pendientes antes de continuar con la
          * simulacion y el rendering.
          */
+        TRACE_BEGIN(tr_events);
+        PROFILE_START(t_events);
         while (SDL_PollEvent(&event)) {
             switch (event.type) {
                 case SDL_QUIT:
                     /* El usuario cerro la ventana (boton X o Cmd+Q) */
                     running = 0;
                     break;
+                case SDL_WINDOWEVENT:
+                    /* Cambio de tamanio: la textura del grid debe regenerarse */
+                    if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+                        renderer_rebuild_grid(renderer);
+                    break;
+                case SDL_RENDER_TARGETS_RESET:
+                case SDL_RENDER_DEVICE_RESET:
+                    /* El driver descarto el contenido de las texturas target */
+                    renderer_rebuild_grid(renderer);
+                    break;
+                case SDL_MOUSEBUTTONDOWN: {
+                    /*
+                     * Click izquierdo pinta, derecho borra. Solo se encola:
+                     * el grid se edita entre generaciones, antes del paso.
+                     */
+                    Edit e;
+                    int cx, cy;
+                    if (!edits || jump.target >= 0) break;
+                    if (event.button.button != SDL_BUTTON_LEFT &&
+                        event.button.button != SDL_BUTTON_RIGHT) break;
+                    if (!renderer_cell_at(renderer, event.button.x, event.button.y, &cx, &cy))
+                        break;
+                    dragging = 1;
+                    drag_kind = event.button.button == SDL_BUTTON_LEFT ? EDIT_PAINT : EDIT_ERASE;
+                    drag_x = view_x + cx;
+                    drag_y = view_y + cy;
+                    e.kind = drag_kind;
+                    e.x0 = e.x1 = drag_x;
+                    e.y0 = e.y1 = drag_y;
+                    edit_queue_push(edits, &e);
+                    break;
+                }
+                case SDL_MOUSEMOTION: {
+                    /* Con un boton apretado, segmento desde la celda anterior */
+                    Edit e;
+                    int cx, cy;
+                    mouse_x = event.motion.x;
+                    mouse_y = event.motion.y;
+                    if (!dragging || jump.target >= 0) break;
+                    if (!renderer_cell_at(renderer, mouse_x, mouse_y, &cx, &cy)) break;
+                    e.kind = drag_kind;
+                    e.x0 = drag_x;
+                    e.y0 = drag_y;
+                    e.x1 = drag_x = view_x + cx;
+                    e.y1 = drag_y = view_y + cy;
+                    edit_queue_push(edits, &e);
+                    break;
+                }
+                case SDL_MOUSEBUTTONUP:
+                    dragging = 0;
+                    break;
                 case SDL_KEYDOWN:
+                    /* Mientras se escribe el destino de G, las teclas son del prompt */
+                    if (goto_prompt) {
+                        int done = goto_prompt_key(event.key.keysym.sym, &goto_value);
+                        if (done == 0) break;
+                        goto_prompt = 0;
+                        if (done < 0) break;
+                        if (goto_value > generation)
+                            jump_begin(&jump, game, generation, goto_value, 1);
+                        else
+                            fprintf(stderr, "Generation %ld is not ahead of the current one (%ld)\n",
+                                    goto_value, generation);
+                        break;
+                    }
+                    /* Durante un salto solo se atiende la cancelacion */
+                    if (jump.target >= 0) {
+                        if (event.key.keysym.sym == SDLK_ESCAPE || event.key.keysym.sym == SDLK_g) {
+                            jump_end(&jump, game);
+                            paused = 1;
+                        }
+                        break;
+                    }
                     switch (event.key.keysym.sym) {
                         case SDLK_ESCAPE:
                             /* ESC: salir de la aplicacion */
@@ -214,33 +731,142 @@ int main(int argc, char *argv[]) {
                             paused = !paused;
                             break;
                         case SDLK_r:
-                            /* R: regenerar grid aleatorio y resetear contador */
-                            game_randomize(game, density);
+                            /*
+                             * R: regenerar grid aleatorio y resetear contador.
+                             * Cada regeneracion usa la semilla siguiente derivada
+                             * de la inicial, asi la secuencia tambien es reproducible.
+                             */
+                            game_randomize(game, density, rng_at(seed, ++reseeds));
+                            if (universe && !universe_from_game(universe, game, view_x, view_y))
+                                fprintf(stderr, "Out of memory while reseeding\n");
                             generation = 0;
+                            if (history) history_record(history, game, generation);
+                            break;
+                        case SDLK_s: {
+                            /* S: guardar el grid actual en el archivo de snapshot */
+                            int saved;
+                            TRACE_BEGIN(tr_save);
+                            PROFILE_START(t_save);
+                            saved = pattern_save_file(game, snapshot_path);
+                            PROFILE_STOP(PROFILE_IO, t_save);
+                            TRACE_END(TRACE_SNAPSHOT, 0, tr_save);
+                            if (!saved)
+                                fprintf(stderr, "Failed to save snapshot: %s\n", snapshot_path);
+                            break;
+                        }
+                        case SDLK_COMMA:
+                        case SDLK_LEFTBRACKET: {
+                            /*
+                             * , y [: volver atras desde el historial. Se pausa
+                             * para poder recorrerlo de a una generacion; al
+                             * reanudar, la simulacion sigue desde ahi.
+                             */
+                            long back = event.key.keysym.sym == SDLK_COMMA ? 1 : REWIND_JUMP;
+                            long gen;
+                            if (!history) {
+                                fprintf(stderr, "Rewinding needs --history-mb N\n");
+                                break;
+                            }
+                            gen = history_rewind(history, game, generation - back);
+                            if (gen >= 0) generation = gen;
+                            paused = 1;
+                            break;
+                        }
+                        case SDLK_PERIOD:
+                            /* .: avanzar una sola generacion estando en pausa */
+                            if (!paused) break;
+                            if (universe) {
+                                if (!universe_step(universe)) break;
+                                universe_to_game(universe, game, view_x, view_y);
+                            } else {
+                                game_step(game);
+                            }
+                            generation++;
+                            if (history) history_record(history, game, generation);
+                            break;
+                        case SDLK_1:
+                        case SDLK_2:
+                        case SDLK_3:
+                        case SDLK_4:
+                        case SDLK_5:
+                        case SDLK_6: {
+                            /* 1-6: estampar un patron predefinido bajo el cursor */
+                            Edit e;
+                            int cx, cy;
+                            if (!edits) break;
+                            if (!renderer_cell_at(renderer, mouse_x, mouse_y, &cx, &cy)) break;
+                            e.kind = EDIT_STAMP;
+                            e.pattern = (PatternType)(PATTERN_GLIDER + (event.key.keysym.sym - SDLK_1));
+                            e.x0 = e.x1 = view_x + cx;
+                            e.y0 = e.y1 = view_y + cy;
+                            edit_queue_push(edits, &e);
+                            break;
+                        }
+                        case SDLK_g:
+                            /* G: abrir el prompt del destino; el titulo lo muestra */
+                            goto_prompt = 1;
+                            goto_value = -1;
+                            break;
+                        case SDLK_p:
+                            /* P: histogramas de tiempos por zona hasta ahora */
+                            profile_report(stderr);
+                            break;
+                        case SDLK_h:
+                            /*
+                             * H: ciclar heatmap apagado → edad → actividad.
+                             * Al apagarlo se libera el buffer heat, por lo que
+                             * game_step vuelve a no tener costo adicional.
+                             */
+                            if (!universe)
+                                game_set_tracking(game, (GameTrack)((game->track + 1) % 3));
+                            break;
+                        case SDLK_LEFT:
+                        case SDLK_RIGHT:
+                        case SDLK_UP:
+                        case SDLK_DOWN:
+                            /*
+                             * Flechas: desplazar la ventana un cuarto de su
+                             * tamanio. Solo tiene sentido sobre el plano
+                             * infinito; el grid fijo ya se ve completo.
+                             */
+                            if (!universe) break;
+                            switch (event.key.keysym.sym) {
+                                case SDLK_LEFT:  view_x -= grid_w / 4 + 1; break;
+                                case SDLK_RIGHT: view_x += grid_w / 4 + 1; break;
+                                case SDLK_UP:    view_y -= grid_h / 4 + 1; break;
+                                default:         view_y += grid_h / 4 + 1; break;
+                            }
+                            universe_to_game(universe, game, view_x, view_y);
                             break;
                         case SDLK_PLUS:
                         case SDLK_EQUALS:
                             /*
-                             * +/=: incrementar FPS target.
+                             * +/=: incrementar la velocidad.
                              * Se usa SDLK_EQUALS porque en la mayoria de teclados
                              * el + esta en la misma tecla que = (sin shift).
-                             * Se recalcula frame_delay inmediatamente.
+                             * El pacer recalcula la duracion del frame de inmediato.
                              */
-                            if (target_fps < 60) {
-                                target_fps += 2;
-                                frame_delay = 1000 / target_fps;
-                            }
+                            gens_per_sec = adjust_speed(gens_per_sec, 1);
+                            pacer_set_speed(&pacer, gens_per_sec);
+                            break;
+                        case SDLK_z:
+                        case SDLK_x:
+                            /*
+                             * Z/X: acercar o alejar. La ventana cambia de
+                             * tamanio con el grid y la textura de lineas se
+                             * vuelve a generar con el nuevo espaciado.
+                             */
+                            renderer_set_cell_size(renderer,
+                                adjust_zoom(renderer->cell_size,
+                                            event.key.keysym.sym == SDLK_z ? 1 : -1));
                             break;
                         case SDLK_MINUS:
                             /*
-                             * -: decrementar FPS target.
-                             * Se asegura que no baje de 1 FPS (minimo funcional).
+                             * -: decrementar la velocidad.
+                             * Se asegura que no baje de 1 gen/s (minimo funcional).
                              */
-                            if (target_fps > 1) {
-                                target_fps -= 2;
-                                if (target_fps < 1) target_fps = 1;
-                                frame_delay = 1000 / target_fps;
-                            }
+                            gens_per_sec = adjust_speed(gens_per_sec, -1);
+                            pacer_set_speed(&pacer, gens_per_sec);
                             break;
                         default:
                             break;
@@ -250,42 +876,137 @@ int main(int argc, char *argv[]) {
                     break;
             }
         }
+        PROFILE_STOP(PROFILE_EVENTS, t_events);
+        TRACE_END(TRACE_EVENTS, 0, tr_events);
 
-        /* Avanzar la simulacion solo si no esta en pausa */
-        if (!paused) {
-            game_step(game);
-            generation++;
+        /*
+         * Ediciones pendientes, entre la generacion mostrada y la
+         * siguiente. En --unbounded se editan los tiles del plano y se
+         * vuelve a copiar la ventana; el estado editado entra al
+         * historial como una entrada propia.
+         */
+        if (edits) {
+            int applied = edit_queue_apply(edits, game, universe);
+            if (applied < 0)
+                fprintf(stderr, "Out of memory while editing the universe\n");
+            if (applied != 0) {
+                if (universe) universe_to_game(universe, game, view_x, view_y);
+                if (history) history_record(history, game, generation);
+            }
         }
 
-        /* Renderizar el frame actual y actualizar el HUD */
-        renderer_draw(renderer, game);
-        renderer_draw_hud(renderer, generation, paused, target_fps);
-
         /*
-         * Control de frame rate.
+         * Generaciones de este frame.
          *
-         * Se calcula cuanto tiempo tomo procesar este frame (frame_time).
-         * Si fue menor que frame_delay, SDL_Delay duerme el hilo el
-         * tiempo restante. Esto produce un frame rate estable cercano
-         * al FPS target sin consumir CPU innecesariamente.
-         *
-         * Nota: SDL_Delay tiene una precision de ~1ms dependiendo del OS.
-         * Para aplicaciones criticas se usaria un busy-wait, pero para
-         * esta simulacion la precision de SDL_Delay es adecuada.
+         * El pacer devuelve las que corresponden por el tiempo transcurrido.
+         * Si la simulacion no alcanza dentro del presupuesto del frame, se
+         * corta y se descartan las pendientes (frame skipping): la imagen
+         * sigue fluida y la velocidad efectiva baja en lugar de acumular
+         * un retraso creciente. Con el engine blocked las generaciones se
+         * ejecutan en pasadas de hasta time_block, y el presupuesto se
+         * revisa entre pasadas.
+         */
+        int due = pacer_begin_frame(&pacer, paused || jump.target >= 0);
+        int k, batch;
+        long frame_start_gen = generation;
+        for (k = 0; k < due; k += batch) {
+            METRICS_STEP_BEGIN(t_step);
+            batch = 1;
+            if (universe) {
+                if (!universe_step(universe)) {
+                    fprintf(stderr, "Out of memory growing the universe, pausing\n");
+                    paused = 1;
+                    break;
+                }
+            } else {
+                if (game->engine == GAME_ENGINE_BLOCKED)
+                    batch = due - k < game->time_block ? due - k : game->time_block;
+                game_step_n(game, batch);
+            }
+            METRICS_STEP_END(t_step, batch);
+            generation += batch;
+            if (pacer_over_budget(&pacer)) {
+                pacer_skip(&pacer);
+                break;
+            }
+        }
+
+        /* Salto en curso (G o --start-gen): un tramo por frame */
+        if (jump.target >= 0) {
+            int status = jump_run(&jump, game, universe, &generation);
+            if (status < 0)
+                fprintf(stderr, "Out of memory growing the universe, stopping the jump\n");
+            if (status <= 0) {
+                if (status < 0 || jump.pause_at_end) paused = 1;
+                jump_end(&jump, game);
+            }
+        }
+
+        /* En modo --unbounded, copiar la ventana visible del plano al grid */
+        if (universe && generation != frame_start_gen && jump.target < 0)
+            universe_to_game(universe, game, view_x, view_y);
+
+        /* Un estado por frame en el historial; , recalcula los intermedios */
+        if (history && generation != frame_start_gen)
+            history_record(history, game, generation);
+
+        /*
+         * Renderizar el frame actual y actualizar el HUD. Durante un salto
+         * solo se actualiza el progreso en el titulo: dibujar el grid le
+         * quitaria tiempo al calculo.
          */
-        Uint32 frame_time = SDL_GetTicks() - frame_start;
-        if (frame_time < frame_delay) {
-            SDL_Delay(frame_delay - frame_time);
+        TRACE_BEGIN(tr_render);
+        PROFILE_START(t_render);
+        if (jump.target < 0) renderer_draw(renderer, game);
+        game_stats(game, &stats);
+        if (jump.target >= 0)
+            renderer_draw_goto_progress(renderer, generation, jump.start, jump.target,
+                                        jump_rate(&jump, generation));
+        else if (goto_prompt)
+            renderer_draw_goto_prompt(renderer, goto_value);
+        else
+            renderer_draw_hud(renderer, generation, &stats, paused, gens_per_sec);
+        PROFILE_STOP(PROFILE_RENDER, t_render);
+        TRACE_END(TRACE_RENDER, 0, tr_render);
+
+        /* Con --metrics-port, publicar el estado para el endpoint */
+        if (metrics_publish_due()) {
+            if (universe)
+                metrics_publish((uint64_t)generation, universe_population(universe),
+                                universe_memory(universe) + game_memory(game),
+                                (long)universe_tile_count(universe));
+            else
+                metrics_publish((uint64_t)generation, stats.population, game_memory(game), -1);
         }
+
+        /*
+         * Espera hasta el proximo frame.
+         *
+         * Con vsync, SDL_RenderPresent (dentro de renderer_draw) ya bloqueo
+         * hasta el retrazado vertical. Sin vsync, el pacer duerme hasta el
+         * timestamp objetivo con precision sub-milisegundo. Durante un
+         * salto no se espera: el frame siguiente sigue calculando.
+         */
+        if (jump.target < 0) pacer_end_frame(&pacer, renderer->vsync);
     }
 
     /*
      * Cleanup de recursos en orden inverso a la creacion.
      * Primero el renderer (depende de SDL), luego el game (independiente),
-     * finalmente SDL_Quit que cierra todos los subsistemas SDL.
+     * finalmente SDL_Quit que cierra todos los subsistemas SDL. En un
+     * build con PROFILE=1 antes se imprimen los histogramas de tiempos.
+     * El trace se escribe con los pools ya detenidos, sin workers que
+     * puedan seguir registrando eventos.
      */
+    PROFILE_REPORT(stderr);
+    metrics_stop();
     renderer_destroy(renderer);
+    history_destroy(history);
+    edit_queue_destroy(edits);
+    universe_destroy(universe);
     game_destroy(game);
+    if (!trace_close())
+        fprintf(stderr, "Failed to write trace: %s\n", trace_path);
     SDL_Quit();
     return 0;
 }
@@ -0,0 +1,272 @@
+/*
+ * metrics.c — Servidor HTTP de metrics.h con sockets POSIX y pthreads.
+ *
+ * Publicacion sin locks: cada valor es una variable de 64 bits escrita
+ * solo por el thread de la simulacion con __atomic_store_n y leida por
+ * el servidor con __atomic_load_n. Las latencias van a un ring de
+ * METRICS_WINDOW entradas; el contador de muestras se publica con
+ * release despues de escribir la entrada, asi el servidor nunca lee un
+ * slot sin inicializar.
+ *
+ * El servidor atiende una conexion por vez (un scraper pregunta cada
+ * varios segundos) y espera en poll sobre el socket y un pipe de aviso,
+ * con timeout de un segundo: en cada vuelta actualiza gens/s con las
+ * generaciones calculadas desde la anterior, y metrics_stop lo despierta
+ * escribiendo en el pipe.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime, poll, pipe */
+
+#include <stdio.h>        /* snprintf */
+#include <stdlib.h>       /* qsort */
+#include <string.h>       /* strncmp */
+#include <time.h>         /* clock_gettime */
+#include <pthread.h>      /* pthread_create, pthread_join */
+#include <unistd.h>       /* pipe, read, write, close */
+#include <poll.h>         /* poll */
+#include <sys/socket.h>   /* socket, bind, listen, accept, send */
+#include <netinet/in.h>   /* sockaddr_in, INADDR_LOOPBACK */
+#include <arpa/inet.h>    /* htons, htonl */
+#include "metrics.h"
+
+/* Sin MSG_NOSIGNAL (macOS) se usa SO_NOSIGPIPE en cada conexion */
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/* Espera maxima por el request de un cliente, en ms */
+#define CLIENT_TIMEOUT_MS 1000
+
+int metrics_enabled = 0;
+
+/* Estado publicado (acceso atomico) */
+static uint64_t cur_generation;
+static uint64_t cur_population;
+static uint64_t cur_grid_bytes;
+static long cur_tiles = -1;
+static uint64_t last_publish;  /* Solo del thread de la simulacion */
+static uint64_t gens_total;
+static uint64_t step_ns_total;
+static uint64_t samples;
+static uint64_t window[METRICS_WINDOW];
+
+/* Servidor */
+static int listen_fd = -1;
+static int wake_pipe[2] = { -1, -1 };
+static pthread_t server_thread;
+
+uint64_t metrics_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void metrics_record_step(uint64_t ns, int gens) {
+    uint64_t n = __atomic_load_n(&samples, __ATOMIC_RELAXED);
+    if (gens < 1) return;
+    __atomic_store_n(&window[n % METRICS_WINDOW], ns / (uint64_t)gens, __ATOMIC_RELAXED);
+    __atomic_store_n(&samples, n + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&gens_total, __atomic_load_n(&gens_total, __ATOMIC_RELAXED) + (uint64_t)gens,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&step_ns_total, __atomic_load_n(&step_ns_total, __ATOMIC_RELAXED) + ns,
+                     __ATOMIC_RELAXED);
+}
+
+int metrics_publish_due(void) {
+    return metrics_enabled && (last_publish == 0 || metrics_now() - last_publish >= METRICS_PUBLISH_NS);
+}
+
+void metrics_publish(uint64_t generation, uint64_t population, size_t grid_bytes, long tiles) {
+    last_publish = metrics_now();
+    __atomic_store_n(&cur_generation, generation, __ATOMIC_RELAXED);
+    __atomic_store_n(&cur_population, population, __ATOMIC_RELAXED);
+    __atomic_store_n(&cur_grid_bytes, (uint64_t)grid_bytes, __ATOMIC_RELAXED);
+    __atomic_store_n(&cur_tiles, tiles, __ATOMIC_RELAXED);
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * format_body — Escribe las metricas en buf (de tamanio size) y retorna
+ * la longitud. Los cuantiles salen por rango exacto de una copia
+ * ordenada del ring.
+ */
+static int format_body(char *buf, size_t size, double rate) {
+    static uint64_t sorted[METRICS_WINDOW];
+    static const double qs[3] = { 0.5, 0.9, 0.99 };
+    uint64_t n = __atomic_load_n(&samples, __ATOMIC_ACQUIRE);
+    long tiles = __atomic_load_n(&cur_tiles, __ATOMIC_RELAXED);
+    size_t count = n < METRICS_WINDOW ? (size_t)n : METRICS_WINDOW, i;
+    int len = 0, q;
+
+    for (i = 0; i < count; i++) sorted[i] = __atomic_load_n(&window[i], __ATOMIC_RELAXED);
+    qsort(sorted, count, sizeof(uint64_t), cmp_u64);
+
+#define APPEND(...) \
+    do { \
+        if ((size_t)len < size) len += snprintf(buf + len, size - (size_t)len, __VA_ARGS__); \
+    } while (0)
+
+    APPEND("# HELP gol_generation Current generation (reset by reseeding).\n"
+           "# TYPE gol_generation gauge\ngol_generation %llu\n",
+           (unsigned long long)__atomic_load_n(&cur_generation, __ATOMIC_RELAXED));
+    APPEND("# HELP gol_generations_total Generations computed since start.\n"
+           "# TYPE gol_generations_total counter\ngol_generations_total %llu\n",
+           (unsigned long long)__atomic_load_n(&gens_total, __ATOMIC_RELAXED));
+    APPEND("# HELP gol_generations_per_second Generations computed over the last second.\n"
+           "# TYPE gol_generations_per_second gauge\ngol_generations_per_second %.1f\n", rate);
+    APPEND("# HELP gol_population Live cells.\n"
+           "# TYPE gol_population gauge\ngol_population %llu\n",
+           (unsigned long long)__atomic_load_n(&cur_population, __ATOMIC_RELAXED));
+    APPEND("# HELP gol_step_seconds Time per generation, quantiles over the last %d measurements.\n"
+           "# TYPE gol_step_seconds summary\n", METRICS_WINDOW);
+    for (q = 0; q < 3; q++) {
+        if (count) {
+            size_t rank = (size_t)(qs[q] * (double)count + 0.999999);
+            APPEND("gol_step_seconds{quantile=\"%g\"} %.9f\n", qs[q], sorted[rank - 1] / 1e9);
+        } else {
+            APPEND("gol_step_seconds{quantile=\"%g\"} NaN\n", qs[q]);
+        }
+    }
+    APPEND("gol_step_seconds_sum %.9f\ngol_step_seconds_count %llu\n",
+           __atomic_load_n(&step_ns_total, __ATOMIC_RELAXED) / 1e9, (unsigned long long)n);
+    APPEND("# HELP gol_grid_bytes Memory used by grid buffers.\n"
+           "# TYPE gol_grid_bytes gauge\ngol_grid_bytes %llu\n",
+           (unsigned long long)__atomic_load_n(&cur_grid_bytes, __ATOMIC_RELAXED));
+    if (tiles >= 0)
+        APPEND("# HELP gol_active_tiles Allocated tiles of the unbounded plane.\n"
+               "# TYPE gol_active_tiles gauge\ngol_active_tiles %ld\n", tiles);
+#undef APPEND
+    return (size_t)len < size ? len : (int)size - 1;
+}
+
+/*
+ * send_all — Envia len bytes. Retorna 0 si el cliente cerro la conexion.
+ */
+static int send_all(int fd, const char *p, size_t len) {
+    while (len > 0) {
+        ssize_t w = send(fd, p, len, MSG_NOSIGNAL);
+        if (w <= 0) return 0;
+        p += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+
+/*
+ * serve_client — Lee la linea de request (sin esperar mas de
+ * CLIENT_TIMEOUT_MS) y responde las metricas para GET /metrics o GET /,
+ * 404 para cualquier otra cosa.
+ */
+static void serve_client(int fd, double rate) {
+    static char body[4096];
+    char req[512], head[160];
+    struct pollfd pfd;
+    ssize_t got;
+    int len, ok;
+
+#ifdef SO_NOSIGPIPE
+    {
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+    }
+#endif
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    if (poll(&pfd, 1, CLIENT_TIMEOUT_MS) <= 0) return;
+    got = read(fd, req, sizeof(req) - 1);
+    if (got <= 0) return;
+    req[got] = '\0';
+
+    ok = strncmp(req, "GET /metrics ", 13) == 0 || strncmp(req, "GET /metrics?", 13) == 0 ||
+         strncmp(req, "GET / ", 6) == 0;
+    if (!ok) {
+        static const char not_found[] =
+            "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\n"
+            "Connection: close\r\n\r\nnot found\n";
+        send_all(fd, not_found, sizeof(not_found) - 1);
+        return;
+    }
+    len = format_body(body, sizeof(body), rate);
+    snprintf(head, sizeof(head),
+             "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\n"
+             "Content-Length: %d\r\nConnection: close\r\n\r\n", len);
+    if (send_all(fd, head, strlen(head))) send_all(fd, body, (size_t)len);
+}
+
+/*
+ * server_main — Loop del servidor hasta que metrics_stop escriba en el
+ * pipe de aviso.
+ */
+static void *server_main(void *arg) {
+    struct pollfd fds[2];
+    uint64_t last_t = metrics_now();
+    uint64_t last_gens = __atomic_load_n(&gens_total, __ATOMIC_RELAXED);
+    double rate = 0.0;
+    (void)arg;
+    fds[0].fd = listen_fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = wake_pipe[0];
+    fds[1].events = POLLIN;
+    for (;;) {
+        int ready = poll(fds, 2, 1000);
+        uint64_t t = metrics_now();
+        if (t - last_t >= 1000000000u) {
+            uint64_t gens = __atomic_load_n(&gens_total, __ATOMIC_RELAXED);
+            rate = (double)(gens - last_gens) * 1e9 / (double)(t - last_t);
+            last_t = t;
+            last_gens = gens;
+        }
+        if (ready <= 0) continue;
+        if (fds[1].revents) return NULL;
+        if (fds[0].revents & POLLIN) {
+            int client = accept(listen_fd, NULL, NULL);
+            if (client >= 0) {
+                serve_client(client, rate);
+                close(client);
+            }
+        }
+    }
+}
+
+int metrics_start(int port) {
+    struct sockaddr_in addr;
+    int one = 1;
+    if (metrics_enabled || port < 1 || port > 65535) return 0;
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) return 0;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((unsigned short)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(listen_fd, 4) != 0 || pipe(wake_pipe) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return 0;
+    }
+    if (pthread_create(&server_thread, NULL, server_main, NULL) != 0) {
+        close(listen_fd);
+        close(wake_pipe[0]);
+        close(wake_pipe[1]);
+        listen_fd = wake_pipe[0] = wake_pipe[1] = -1;
+        return 0;
+    }
+    metrics_enabled = 1;
+    return 1;
+}
+
+void metrics_stop(void) {
+    char c = 0;
+    if (!metrics_enabled) return;
+    metrics_enabled = 0;
+    if (write(wake_pipe[1], &c, 1) == 1) pthread_join(server_thread, NULL);
+    close(listen_fd);
+    close(wake_pipe[0]);
+    close(wake_pipe[1]);
+    listen_fd = wake_pipe[0] = wake_pipe[1] = -1;
+}
@@ -0,0 +1,82 @@
+/*
+ * metrics.h — Endpoint HTTP local con metricas de la simulacion.
+ *
+ * Con --metrics-port N un thread propio escucha en 127.0.0.1:N y
+ * responde GET /metrics (o /) en el formato de texto de Prometheus:
+ *   - gol_generation             — Generacion actual (vuelve a 0 con R).
+ *   - gol_generations_total      — Generaciones calculadas desde el inicio.
+ *   - gol_generations_per_second — Ritmo medido en el ultimo segundo.
+ *   - gol_population             — Celdas vivas.
+ *   - gol_step_seconds           — Latencia por generacion: cuantiles
+ *                                  0.5, 0.9 y 0.99 de las ultimas
+ *                                  METRICS_WINDOW mediciones, suma y
+ *                                  cantidad acumuladas.
+ *   - gol_grid_bytes             — Memoria de los buffers del grid.
+ *   - gol_active_tiles           — Tiles alocados (solo --unbounded).
+ *
+ * El thread que avanza la simulacion publica los valores con stores
+ * atomicos y el del servidor los lee con loads atomicos: no hay mutex
+ * entre ambos y publicar cuesta unos pocos stores. Los valores de una
+ * respuesta pueden mezclar dos publicaciones consecutivas, algo sin
+ * importancia para un scraper que pregunta cada varios segundos.
+ */
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
+
+/* Mediciones de latencia de las que se calculan los cuantiles */
+#define METRICS_WINDOW 1024
+
+/* Intervalo minimo entre publicaciones sugerido por metrics_publish_due */
+#define METRICS_PUBLISH_NS 100000000u
+
+/* Distinto de 0 entre metrics_start y metrics_stop */
+extern int metrics_enabled;
+
+/*
+ * metrics_start — Abre el socket en 127.0.0.1:port y lanza el thread
+ * del servidor. Retorna 0 si el puerto no pudo abrirse o el thread no
+ * pudo crearse.
+ */
+int metrics_start(int port);
+
+/*
+ * metrics_stop — Detiene el thread y cierra el socket. Sin servidor
+ * activo no hace nada.
+ */
+void metrics_stop(void);
+
+/*
+ * metrics_now — Reloj monotonico en nanosegundos.
+ */
+uint64_t metrics_now(void);
+
+/*
+ * metrics_record_step — Registra gens generaciones calculadas en ns
+ * nanosegundos. Solo desde el thread que avanza la simulacion.
+ */
+void metrics_record_step(uint64_t ns, int gens);
+
+/*
+ * metrics_publish — Publica el estado actual. tiles < 0 omite
+ * gol_active_tiles (grid con bordes). Solo desde el thread que avanza
+ * la simulacion.
+ */
+void metrics_publish(uint64_t generation, uint64_t population, size_t grid_bytes, long tiles);
+
+/*
+ * metrics_publish_due — 1 si el endpoint esta activo y pasaron al menos
+ * METRICS_PUBLISH_NS desde el ultimo metrics_publish. Evita recalcular
+ * la poblacion de un plano grande en cada generacion.
+ */
+int metrics_publish_due(void);
+
+/* Mide un tramo de pasos en t y lo registra al cerrarlo */
+#define METRICS_STEP_BEGIN(t) uint64_t t = metrics_enabled ? metrics_now() : 0
+#define METRICS_STEP_END(t, gens) \
+    do { if (metrics_enabled) metrics_record_step(metrics_now() - (t), (gens)); } while (0)
+
+#endif
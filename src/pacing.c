@@ -0,0 +1,122 @@
+/*
+ * pacing.c — Implementacion del control de ritmo del loop principal.
+ *
+ * Modelo de deuda de generaciones: cada frame suma a gen_debt el tiempo
+ * transcurrido multiplicado por la velocidad pedida, y se ejecuta la
+ * parte entera. Asi la velocidad media es exacta aunque la duracion de
+ * los frames varie, y una velocidad de 10 gen/s a 60 Hz produce frames
+ * alternados de 0 y 1 generaciones sin truncar 1000 / fps.
+ */
+
+#include "pacing.h"
+
+/* Fraccion del frame reservada para simulacion; el resto es para render */
+#define SIM_BUDGET_NUM 4
+#define SIM_BUDGET_DEN 5
+
+/* Margen en ticks bajo el cual se deja de usar SDL_Delay (2 ms) */
+#define SPIN_MARGIN_MS 2
+
+/*
+ * recompute_frame — Duracion de un frame en ticks.
+ *
+ * El frame rate efectivo es el menor entre la velocidad de simulacion y
+ * el refresco: no tiene sentido presentar mas frames que generaciones
+ * nuevas, ni mas frames de los que el display puede mostrar.
+ */
+static void recompute_frame(Pacer *p) {
+    int fps = p->gens_per_sec < p->refresh_hz ? p->gens_per_sec : p->refresh_hz;
+    if (fps < 1) fps = 1;
+    p->frame_ticks = p->freq / (Uint64)fps;
+}
+
+/*
+ * pacer_init — Lee la frecuencia del contador y fija el origen temporal.
+ */
+void pacer_init(Pacer *p, int gens_per_sec, int refresh_hz) {
+    p->freq = SDL_GetPerformanceFrequency();
+    p->gens_per_sec = gens_per_sec;
+    p->refresh_hz = refresh_hz > 0 ? refresh_hz : 60;
+    p->gen_debt = 0.0;
+    recompute_frame(p);
+    p->last = SDL_GetPerformanceCounter();
+    p->frame_start = p->last;
+    p->next_frame = p->last + p->frame_ticks;
+}
+
+/*
+ * pacer_set_speed — Actualiza la velocidad y la duracion del frame.
+ */
+void pacer_set_speed(Pacer *p, int gens_per_sec) {
+    p->gens_per_sec = gens_per_sec;
+    recompute_frame(p);
+}
+
+/*
+ * pacer_begin_frame — Acumula la deuda del intervalo transcurrido.
+ *
+ * La deuda se limita a un segundo de simulacion para que una pausa
+ * larga del proceso (ventana arrastrada, debugger) no provoque una
+ * rafaga de generaciones al volver.
+ */
+int pacer_begin_frame(Pacer *p, int paused) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    double dt = (double)(now - p->last) / (double)p->freq;
+    p->last = now;
+    p->frame_start = now;
+    if (paused) {
+        p->gen_debt = 0.0;
+        return 0;
+    }
+    p->gen_debt += dt * p->gens_per_sec;
+    if (p->gen_debt > p->gens_per_sec) p->gen_debt = p->gens_per_sec;
+    int due = (int)p->gen_debt;
+    p->gen_debt -= due;
+    return due;
+}
+
+/*
+ * pacer_over_budget — Compara el tiempo del frame con el presupuesto.
+ */
+int pacer_over_budget(const Pacer *p) {
+    Uint64 elapsed = SDL_GetPerformanceCounter() - p->frame_start;
+    return elapsed * SIM_BUDGET_DEN > p->frame_ticks * SIM_BUDGET_NUM;
+}
+
+/*
+ * pacer_skip — Olvida la fraccion pendiente: las generaciones que no
+ * entraron en el presupuesto no se arrastran al frame siguiente.
+ */
+void pacer_skip(Pacer *p) {
+    p->gen_debt = 0.0;
+}
+
+/*
+ * pacer_end_frame — Espera hasta next_frame (solo sin vsync).
+ *
+ * 1. Si ya se paso el objetivo (frame lento), se resincroniza el
+ *    objetivo con el presente en lugar de intentar recuperar.
+ * 2. Mientras falten mas de SPIN_MARGIN_MS, se duerme con SDL_Delay
+ *    dejando ese margen, porque SDL_Delay puede despertar tarde.
+ * 3. El resto se completa con espera activa sobre el contador.
+ */
+void pacer_end_frame(Pacer *p, int vsync) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (vsync) {
+        p->next_frame = now + p->frame_ticks;
+        return;
+    }
+    if (now >= p->next_frame) {
+        p->next_frame = now + p->frame_ticks;
+        return;
+    }
+    Uint64 ms_ticks = p->freq / 1000;
+    Uint64 remaining = p->next_frame - now;
+    if (remaining > ms_ticks * SPIN_MARGIN_MS) {
+        SDL_Delay((Uint32)((remaining - ms_ticks * SPIN_MARGIN_MS) / ms_ticks));
+    }
+    while (SDL_GetPerformanceCounter() < p->next_frame) {
+        /* espera activa: menos de SPIN_MARGIN_MS */
+    }
+    p->next_frame += p->frame_ticks;
+}
@@ -0,0 +1,87 @@
+/*
+ * pacing.h — Control de ritmo del loop principal con timers de alta resolucion.
+ *
+ * Separa dos frecuencias que antes estaban acopladas:
+ *   - Generaciones por segundo (la velocidad de simulacion pedida).
+ *   - Frames por segundo (la cadencia de presentacion en pantalla).
+ *
+ * Los frames se presentan como maximo a la frecuencia de refresco del
+ * display. Si la velocidad pedida la supera (por ejemplo 10000 gen/s en
+ * un monitor de 60 Hz), cada frame ejecuta varias generaciones
+ * ("generaciones por frame"). Si la CPU no alcanza, las generaciones
+ * pendientes se descartan en lugar de acumularse (frame skipping sin
+ * espiral de retraso).
+ *
+ * Todas las medidas usan SDL_GetPerformanceCounter, con resolucion de
+ * microsegundos o mejor, en lugar de los milisegundos de SDL_GetTicks.
+ */
+
+#ifndef PACING_H
+#define PACING_H
+
+#include <SDL.h>    /* Uint64, SDL_GetPerformanceCounter */
+
+/*
+ * Pacer — Estado del control de ritmo.
+ *
+ * freq         — Ticks por segundo del contador de alto rendimiento.
+ * last         — Timestamp (ticks) del inicio del frame anterior.
+ * frame_start  — Timestamp del inicio del frame actual.
+ * next_frame   — Timestamp objetivo del proximo frame (sin vsync).
+ * frame_ticks  — Duracion de un frame en ticks: 1 / min(gen/s, refresco).
+ * gen_debt     — Generaciones pendientes acumuladas (fraccionario).
+ * gens_per_sec — Velocidad de simulacion pedida.
+ * refresh_hz   — Frecuencia de refresco del display.
+ */
+typedef struct {
+    Uint64 freq;
+    Uint64 last;
+    Uint64 frame_start;
+    Uint64 next_frame;
+    Uint64 frame_ticks;
+    double gen_debt;
+    int gens_per_sec;
+    int refresh_hz;
+} Pacer;
+
+/*
+ * pacer_init — Inicializa el pacer con la velocidad y el refresco dados.
+ * refresh_hz <= 0 se interpreta como 60 Hz.
+ */
+void pacer_init(Pacer *p, int gens_per_sec, int refresh_hz);
+
+/*
+ * pacer_set_speed — Cambia la velocidad de simulacion en caliente.
+ * Recalcula la duracion del frame sin perder el timestamp de referencia.
+ */
+void pacer_set_speed(Pacer *p, int gens_per_sec);
+
+/*
+ * pacer_begin_frame — Marca el inicio de un frame y retorna cuantas
+ * generaciones corresponde ejecutar en el. Con paused != 0 retorna 0
+ * y no acumula deuda.
+ */
+int pacer_begin_frame(Pacer *p, int paused);
+
+/*
+ * pacer_over_budget — Retorna 1 si el tiempo consumido en el frame actual
+ * ya supera el presupuesto para simulacion (80% del frame). El loop de
+ * generaciones la consulta para cortar y dejar tiempo al rendering.
+ */
+int pacer_over_budget(const Pacer *p);
+
+/*
+ * pacer_skip — Descarta las generaciones pendientes que no se llegaron a
+ * ejecutar. Se llama cuando pacer_over_budget corta el loop.
+ */
+void pacer_skip(Pacer *p);
+
+/*
+ * pacer_end_frame — Espera hasta el inicio del proximo frame.
+ * Con vsync activo no espera: SDL_RenderPresent ya bloquea hasta el
+ * retrazado vertical. Sin vsync duerme con SDL_Delay la parte gruesa
+ * y completa con una espera activa corta para precision sub-milisegundo.
+ */
+void pacer_end_frame(Pacer *p, int vsync);
+
+#endif
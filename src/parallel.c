@@ -0,0 +1,195 @@
+/*
+ * parallel.c — Implementacion del pool de threads con pthreads.
+ *
+ * Sincronizacion:
+ *   - job_seq identifica el trabajo actual. pool_run lo incrementa bajo el
+ *     mutex y hace broadcast de cv_start; cada worker recuerda el ultimo
+ *     job_seq que proceso y despierta solo ante uno nuevo.
+ *   - pending cuenta los workers que aun no terminaron su tramo; el ultimo
+ *     en terminar senala cv_done, donde espera el thread que llamo.
+ * Con --trace, cada tramo se registra como "chunk" con el indice del
+ * worker como thread, y la espera en cv_done como "barrier".
+ * Los tramos se calculan con la misma formula en todos los threads, por
+ * lo que no hace falta una cola de trabajo.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* sysconf, _SC_NPROCESSORS_ONLN */
+
+#include <stdlib.h>   /* malloc, free */
+#include <pthread.h>  /* pthread_create, mutex, cond */
+#include <unistd.h>   /* sysconf */
+#include "parallel.h"
+#include "trace.h"
+
+/* Limite de threads por pool */
+#define MAX_THREADS 256
+
+/*
+ * WorkerArg — Argumento de cada worker: el pool y su indice (>= 1).
+ */
+typedef struct {
+    ThreadPool *pool;
+    int index;
+} WorkerArg;
+
+struct ThreadPool {
+    int nthreads;
+    pthread_t *threads;
+    WorkerArg *args;
+    pthread_mutex_t mu;
+    pthread_cond_t cv_start;
+    pthread_cond_t cv_done;
+    unsigned long job_seq;
+    int pending;
+    int quit;
+    /* Trabajo actual */
+    ParallelFn fn;
+    void *ctx;
+    size_t n;
+    int chunks;
+};
+
+/*
+ * run_chunk — Ejecuta el tramo numero c del trabajo actual.
+ * El tramo c cubre [n * c / chunks, n * (c + 1) / chunks).
+ */
+static void run_chunk(ThreadPool *p, int c) {
+    size_t begin = p->n / (size_t)p->chunks * (size_t)c +
+                   p->n % (size_t)p->chunks * (size_t)c / (size_t)p->chunks;
+    size_t end = p->n / (size_t)p->chunks * (size_t)(c + 1) +
+                 p->n % (size_t)p->chunks * (size_t)(c + 1) / (size_t)p->chunks;
+    TRACE_BEGIN(t);
+    if (begin >= end) return;
+    p->fn(p->ctx, begin, end, c);
+    TRACE_END(TRACE_CHUNK, c, t);
+}
+
+/*
+ * worker_main — Loop de cada worker: esperar trabajo nuevo, ejecutar su
+ * tramo (si le toca uno) y reportar fin.
+ */
+static void *worker_main(void *arg) {
+    WorkerArg *wa = arg;
+    ThreadPool *p = wa->pool;
+    unsigned long seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&p->mu);
+        while (!p->quit && p->job_seq == seen)
+            pthread_cond_wait(&p->cv_start, &p->mu);
+        if (p->quit) {
+            pthread_mutex_unlock(&p->mu);
+            return NULL;
+        }
+        seen = p->job_seq;
+        pthread_mutex_unlock(&p->mu);
+
+        if (wa->index < p->chunks) run_chunk(p, wa->index);
+
+        pthread_mutex_lock(&p->mu);
+        if (--p->pending == 0) pthread_cond_signal(&p->cv_done);
+        pthread_mutex_unlock(&p->mu);
+    }
+}
+
+/*
+ * pool_create — Inicializa sincronizacion y lanza nthreads - 1 workers.
+ * Si la creacion de un worker falla, el pool queda con los que se
+ * lograron crear (como minimo el thread que llama).
+ */
+ThreadPool *pool_create(int nthreads) {
+    ThreadPool *p = malloc(sizeof(ThreadPool));
+    int i;
+    if (!p) return NULL;
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > MAX_THREADS) nthreads = MAX_THREADS;
+    p->threads = malloc(sizeof(pthread_t) * (size_t)nthreads);
+    p->args = malloc(sizeof(WorkerArg) * (size_t)nthreads);
+    if (!p->threads || !p->args) {
+        free(p->threads);
+        free(p->args);
+        free(p);
+        return NULL;
+    }
+    pthread_mutex_init(&p->mu, NULL);
+    pthread_cond_init(&p->cv_start, NULL);
+    pthread_cond_init(&p->cv_done, NULL);
+    p->job_seq = 0;
+    p->pending = 0;
+    p->quit = 0;
+    p->chunks = 1;
+    p->nthreads = 1;
+    for (i = 1; i < nthreads; i++) {
+        p->args[i].pool = p;
+        p->args[i].index = i;
+        if (pthread_create(&p->threads[i], NULL, worker_main, &p->args[i]) != 0) break;
+        p->nthreads++;
+    }
+    return p;
+}
+
+void pool_destroy(ThreadPool *p) {
+    int i;
+    if (!p) return;
+    pthread_mutex_lock(&p->mu);
+    p->quit = 1;
+    pthread_cond_broadcast(&p->cv_start);
+    pthread_mutex_unlock(&p->mu);
+    for (i = 1; i < p->nthreads; i++) pthread_join(p->threads[i], NULL);
+    pthread_mutex_destroy(&p->mu);
+    pthread_cond_destroy(&p->cv_start);
+    pthread_cond_destroy(&p->cv_done);
+    free(p->threads);
+    free(p->args);
+    free(p);
+}
+
+int pool_threads(const ThreadPool *p) {
+    return p ? p->nthreads : 1;
+}
+
+/*
+ * pool_run — Publica el trabajo, procesa el tramo 0 y espera la barrera.
+ * Todos los workers participan de la barrera aunque no tengan tramo,
+ * para que ninguno quede procesando un job_seq viejo.
+ */
+void pool_run(ThreadPool *p, size_t n, size_t grain, ParallelFn fn, void *ctx) {
+    size_t chunks;
+    if (n == 0) return;
+    if (grain == 0) grain = 1;
+    chunks = (n + grain - 1) / grain;
+    if (!p || p->nthreads == 1 || chunks <= 1) {
+        TRACE_BEGIN(t);
+        fn(ctx, 0, n, 0);
+        TRACE_END(TRACE_CHUNK, 0, t);
+        return;
+    }
+    if (chunks > (size_t)p->nthreads) chunks = (size_t)p->nthreads;
+
+    pthread_mutex_lock(&p->mu);
+    p->fn = fn;
+    p->ctx = ctx;
+    p->n = n;
+    p->chunks = (int)chunks;
+    p->pending = p->nthreads - 1;
+    p->job_seq++;
+    pthread_cond_broadcast(&p->cv_start);
+    pthread_mutex_unlock(&p->mu);
+
+    run_chunk(p, 0);
+
+    {
+        TRACE_BEGIN(t);
+        pthread_mutex_lock(&p->mu);
+        while (p->pending > 0)
+            pthread_cond_wait(&p->cv_done, &p->mu);
+        pthread_mutex_unlock(&p->mu);
+        TRACE_END(TRACE_BARRIER, 0, t);
+    }
+}
+
+int parallel_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    if (n > MAX_THREADS) return MAX_THREADS;
+    return (int)n;
+}
@@ -0,0 +1,59 @@
+/*
+ * parallel.h — Pool de threads persistente para trabajo data-parallel.
+ *
+ * El modelo es un "parallel for" con barrera: pool_run divide un rango de
+ * items [0, n) en tramos contiguos, uno por thread, ejecuta la funcion
+ * sobre cada tramo y retorna cuando todos terminaron. El thread que llama
+ * procesa el primer tramo, asi que un pool de N threads crea N-1 workers.
+ *
+ * Los workers se crean una sola vez y esperan en una variable de condicion
+ * entre trabajos, de modo que el costo por llamada es una senal y una
+ * barrera, no la creacion de threads.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>  /* size_t */
+
+/*
+ * ParallelFn — Trabajo a ejecutar sobre el tramo [begin, end).
+ * worker es el indice del thread (0 = el que llamo a pool_run), util
+ * para estado por thread como contadores o free lists.
+ */
+typedef void (*ParallelFn)(void *ctx, size_t begin, size_t end, int worker);
+
+typedef struct ThreadPool ThreadPool;
+
+/*
+ * pool_create — Crea un pool de nthreads threads (incluyendo el que
+ * llama). nthreads <= 1 produce un pool que ejecuta todo en linea.
+ * Retorna NULL si falla la creacion.
+ */
+ThreadPool *pool_create(int nthreads);
+
+/*
+ * pool_destroy — Detiene y une los workers y libera el pool. Acepta NULL.
+ */
+void pool_destroy(ThreadPool *pool);
+
+/*
+ * pool_threads — Cantidad de threads del pool (1 si pool es NULL).
+ */
+int pool_threads(const ThreadPool *pool);
+
+/*
+ * pool_run — Ejecuta fn sobre [0, n) repartido entre los threads.
+ *
+ * grain es el minimo de items por tramo: con n pequenio se usan menos
+ * threads para no pagar sincronizacion por poco trabajo. Con pool NULL
+ * o de un thread, fn se llama una vez con el rango completo.
+ */
+void pool_run(ThreadPool *pool, size_t n, size_t grain, ParallelFn fn, void *ctx);
+
+/*
+ * parallel_cpu_count — Procesadores en linea segun el sistema (>= 1).
+ */
+int parallel_cpu_count(void);
+
+#endif
@@ -0,0 +1,488 @@
+/*
+ * pattern_io.c — Implementacion de los lectores/escritores .cells y .mc.
+ *
+ * El lector .cells es una maquina de estados caracter a caracter: no
+ * necesita buffers de linea y acepta filas de cualquier longitud.
+ *
+ * El lector .mc procesa una linea por vez. Cada linea produce un nodo
+ * canonico del QuadTree que se guarda en un array indexado por numero
+ * de linea, porque los nodos posteriores referencian a los anteriores
+ * por ese numero (1-based; 0 significa "vacio").
+ *
+ * El escritor .mc recorre el quadtree en post-orden y numera cada nodo
+ * distinto la primera vez que lo ve (usando los campos tag/epoch del
+ * nodo), de modo que los subarboles compartidos se emiten una sola vez.
+ */
+
+#include <stdlib.h>  /* malloc, realloc, free, strtoul */
+#include <stdio.h>   /* sscanf */
+#include <string.h>  /* strlen, strrchr, strchr */
+#include <ctype.h>   /* tolower, isdigit */
+#include <limits.h>  /* INT_MAX */
+#include "pattern_io.h"
+
+/* Lado de una hoja del formato Macrocell (8x8 celdas, nivel 3) */
+#define MC_LEAF_LEVEL 3
+#define MC_LEAF_SIZE 8
+
+/* Longitud maxima de linea aceptada en un .mc */
+#define MC_LINE_MAX 1024
+
+/*
+ * ext_equals — Compara la extension de path (sin distinguir mayusculas).
+ */
+static int ext_equals(const char *path, const char *ext) {
+    const char *dot = strrchr(path, '.');
+    if (!dot) return 0;
+    while (*dot && *ext) {
+        if (tolower((unsigned char)*dot) != tolower((unsigned char)*ext)) return 0;
+        dot++;
+        ext++;
+    }
+    return *dot == '\0' && *ext == '\0';
+}
+
+PatternFormat pattern_format_from_path(const char *path) {
+    if (ext_equals(path, ".cells")) return PATTERN_FMT_CELLS;
+    if (ext_equals(path, ".mc")) return PATTERN_FMT_MC;
+    return PATTERN_FMT_UNKNOWN;
+}
+
+/*
+ * pattern_read_cells — Maquina de estados de dos modos.
+ *
+ * Al inicio de linea, un '!' activa el modo comentario hasta el '\n'.
+ * En modo datos, 'O' y '*' activan la celda, '.' avanza la columna,
+ * '\n' pasa a la fila siguiente y '\r' o espacios finales se ignoran.
+ * Cualquier otro caracter invalida el archivo.
+ */
+int pattern_read_cells(FILE *f, Game *g, int x, int y) {
+    int c;
+    int col = 0, row = 0;
+    int comment = 0;
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') {
+            if (!comment) row++;
+            comment = 0;
+            col = 0;
+            continue;
+        }
+        if (comment) continue;
+        if (col == 0 && c == '!') {
+            comment = 1;
+            continue;
+        }
+        if (c == 'O' || c == '*') {
+            game_set_cell(g, x + col, y + row, 1);
+            col++;
+        } else if (c == '.') {
+            col++;
+        } else if (c != '\r' && c != ' ' && c != '\t') {
+            return 0;
+        }
+    }
+    return !ferror(f);
+}
+
+/*
+ * pattern_write_cells — Calcula el bounding box de las celdas vivas y
+ * escribe una fila por linea, recortando los '.' finales de cada fila
+ * (el formato los permite omitir). La esquina del bounding box va en un
+ * comentario "!Origin: x y" (ver pattern_file_origin). Un grid vacio
+ * produce solo la cabecera.
+ */
+int pattern_write_cells(FILE *f, Game *g, const char *name) {
+    int x, y;
+    int x0 = g->width, y0 = g->height, x1 = -1, y1 = -1;
+    for (y = 0; y < g->height; y++) {
+        for (x = 0; x < g->width; x++) {
+            if (game_get_cell(g, x, y)) {
+                if (x < x0) x0 = x;
+                if (x > x1) x1 = x;
+                if (y < y0) y0 = y;
+                if (y > y1) y1 = y;
+            }
+        }
+    }
+    if (name) fprintf(f, "!Name: %s\n", name);
+    if (y1 >= 0) fprintf(f, "!Origin: %d %d\n", x0, y0);
+    for (y = y0; y <= y1; y++) {
+        int last = x0 - 1;
+        for (x = x0; x <= x1; x++) {
+            if (game_get_cell(g, x, y)) last = x;
+        }
+        for (x = x0; x <= last; x++) {
+            fputc(game_get_cell(g, x, y) ? 'O' : '.', f);
+        }
+        fputc('\n', f);
+    }
+    return !ferror(f);
+}
+
+/*
+ * build_leaf — Construye el nodo de nivel level cuya esquina es (x0, y0)
+ * dentro de la hoja 8x8 bits[fila][columna].
+ */
+static QNode *build_leaf(QuadTree *qt, unsigned char bits[MC_LEAF_SIZE][MC_LEAF_SIZE],
+                         int level, int x0, int y0) {
+    if (level == 0) return qt_leaf(qt, bits[y0][x0]);
+    int half = 1 << (level - 1);
+    QNode *nw = build_leaf(qt, bits, level - 1, x0, y0);
+    QNode *ne = build_leaf(qt, bits, level - 1, x0 + half, y0);
+    QNode *sw = build_leaf(qt, bits, level - 1, x0, y0 + half);
+    QNode *se = build_leaf(qt, bits, level - 1, x0 + half, y0 + half);
+    if (!nw || !ne || !sw || !se) return NULL;
+    return qt_node(qt, nw, ne, sw, se);
+}
+
+/*
+ * parse_mc_leaf — Decodifica una linea de hoja: '.' muerta, '*' viva,
+ * '$' fin de fila. Retorna NULL si la linea excede 8x8.
+ */
+static QNode *parse_mc_leaf(QuadTree *qt, const char *line) {
+    unsigned char bits[MC_LEAF_SIZE][MC_LEAF_SIZE];
+    int row = 0, col = 0;
+    memset(bits, 0, sizeof(bits));
+    for (; *line && *line != '\n' && *line != '\r'; line++) {
+        if (*line == '$') {
+            row++;
+            col = 0;
+            continue;
+        }
+        if (row >= MC_LEAF_SIZE || col >= MC_LEAF_SIZE) return NULL;
+        if (*line == '*') bits[row][col] = 1;
+        else if (*line != '.') return NULL;
+        col++;
+    }
+    return build_leaf(qt, bits, MC_LEAF_LEVEL, 0, 0);
+}
+
+/*
+ * mc_child — Resuelve una referencia de hijo: 0 es el nodo vacio del
+ * nivel pedido; cualquier otro valor debe apuntar a una linea anterior
+ * del nivel correcto.
+ */
+static QNode *mc_child(QuadTree *qt, QNode **nodes, unsigned long count,
+                       unsigned long idx, int level) {
+    if (idx == 0) return qt_empty(qt, level);
+    if (idx > count || nodes[idx - 1]->level != level) return NULL;
+    return nodes[idx - 1];
+}
+
+/*
+ * parse_mc_node — Decodifica "nivel nw ne sw se".
+ */
+static QNode *parse_mc_node(QuadTree *qt, const char *line,
+                            QNode **nodes, unsigned long count) {
+    char *end;
+    unsigned long level = strtoul(line, &end, 10);
+    unsigned long idx[4];
+    QNode *child[4];
+    int k;
+    if (level <= MC_LEAF_LEVEL || level > QT_MAX_LEVEL) return NULL;
+    for (k = 0; k < 4; k++) {
+        const char *p = end;
+        idx[k] = strtoul(p, &end, 10);
+        if (end == p) return NULL;
+        child[k] = mc_child(qt, nodes, count, idx[k], (int)level - 1);
+        if (!child[k]) return NULL;
+    }
+    return qt_node(qt, child[0], child[1], child[2], child[3]);
+}
+
+/*
+ * pattern_read_mc — Lee el archivo linea a linea.
+ *
+ * Lineas que empiezan con '[' (cabecera "[M2]") o '#' (metadatos como
+ * "#R" regla o "#G" generacion) se ignoran. Las hojas empiezan con
+ * '.', '*' o '$'; los nodos con un digito. La raiz es el ultimo nodo.
+ */
+int pattern_read_mc(FILE *f, QuadTree *qt, QNode **root) {
+    char line[MC_LINE_MAX];
+    QNode **nodes = NULL;
+    unsigned long count = 0, cap = 0;
+    int ok = 1;
+    while (ok && fgets(line, sizeof(line), f)) {
+        QNode *n;
+        if (!strchr(line, '\n') && !feof(f)) {
+            ok = 0;
+            break;
+        }
+        if (line[0] == '[' || line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+        if (line[0] == '.' || line[0] == '*' || line[0] == '$')
+            n = parse_mc_leaf(qt, line);
+        else if (isdigit((unsigned char)line[0]))
+            n = parse_mc_node(qt, line, nodes, count);
+        else
+            n = NULL;
+        if (!n) {
+            ok = 0;
+            break;
+        }
+        if (count == cap) {
+            unsigned long ncap = cap ? cap * 2 : 256;
+            QNode **grown = realloc(nodes, ncap * sizeof(QNode *));
+            if (!grown) {
+                ok = 0;
+                break;
+            }
+            nodes = grown;
+            cap = ncap;
+        }
+        nodes[count++] = n;
+    }
+    if (ok && count == 0) ok = 0;
+    if (ok) *root = nodes[count - 1];
+    free(nodes);
+    return ok && !ferror(f);
+}
+
+/*
+ * write_mc_leaf — Emite una hoja 8x8 recortando los '.' finales de
+ * cada fila; cada fila termina en '$'.
+ */
+static void write_mc_leaf(FILE *f, const QNode *n) {
+    int x, y;
+    for (y = 0; y < MC_LEAF_SIZE; y++) {
+        int last = -1;
+        for (x = 0; x < MC_LEAF_SIZE; x++) {
+            if (qt_get_cell(n, x, y)) last = x;
+        }
+        for (x = 0; x <= last; x++) {
+            fputc(qt_get_cell(n, x, y) ? '*' : '.', f);
+        }
+        fputc('$', f);
+    }
+    fputc('\n', f);
+}
+
+/*
+ * write_mc_node — Post-orden con memo en tag/epoch.
+ *
+ * Retorna el numero de linea asignado al nodo (0 para nodos vacios, que
+ * el formato no escribe). Primero se emiten los hijos para que sus
+ * numeros existan cuando se escribe la linea del padre.
+ */
+static unsigned long write_mc_node(FILE *f, QNode *n, unsigned epoch,
+                                   unsigned long *next_id) {
+    if (n->population == 0) return 0;
+    if (n->epoch == epoch) return n->tag;
+    if (n->level == MC_LEAF_LEVEL) {
+        write_mc_leaf(f, n);
+    } else {
+        unsigned long a = write_mc_node(f, n->nw, epoch, next_id);
+        unsigned long b = write_mc_node(f, n->ne, epoch, next_id);
+        unsigned long c = write_mc_node(f, n->sw, epoch, next_id);
+        unsigned long d = write_mc_node(f, n->se, epoch, next_id);
+        fprintf(f, "%d %lu %lu %lu %lu\n", n->level, a, b, c, d);
+    }
+    n->epoch = epoch;
+    n->tag = ++*next_id;
+    return n->tag;
+}
+
+/*
+ * expand_root — Duplica el lado de la raiz manteniendo su centro en el
+ * origen: cada cuadrante original pasa a ser el cuadrante interior del
+ * cuadrante correspondiente de la nueva raiz.
+ */
+static QNode *expand_root(QuadTree *qt, QNode *r) {
+    QNode *e = qt_empty(qt, r->level - 1);
+    QNode *nw = qt_node(qt, e, e, e, r->nw);
+    QNode *ne = qt_node(qt, e, e, r->ne, e);
+    QNode *sw = qt_node(qt, e, r->sw, e, e);
+    QNode *se = qt_node(qt, r->se, e, e, e);
+    if (!nw || !ne || !sw || !se) return NULL;
+    return qt_node(qt, nw, ne, sw, se);
+}
+
+/*
+ * write_mc — Cabecera + nodos en post-orden. Con origin, la cabecera
+ * lleva ademas "#C Origin: 0 0" (ver pattern_file_origin).
+ *
+ * El formato exige que las hojas sean de nivel 3, asi que una raiz mas
+ * chica se expande (centrada) hasta ese nivel. Una raiz vacia se emite
+ * como una hoja vacia, porque el lector exige al menos un nodo.
+ */
+static int write_mc(FILE *f, QuadTree *qt, QNode *root, int origin) {
+    unsigned long next_id = 0;
+    if (root->level == 0) return 0;
+    while (root && root->level <= MC_LEAF_LEVEL) root = expand_root(qt, root);
+    if (!root) return 0;
+    fprintf(f, "[M2] (dosdoseis)\n#R B3/S23\n");
+    if (origin) fprintf(f, "#C Origin: 0 0\n");
+    if (root->population == 0) {
+        fprintf(f, "$\n");
+    } else {
+        write_mc_node(f, root, qt_next_epoch(qt), &next_id);
+    }
+    return !ferror(f);
+}
+
+int pattern_write_mc(FILE *f, QuadTree *qt, QNode *root) {
+    return write_mc(f, qt, root, 0);
+}
+
+/*
+ * measure_cells — Recorre un .cells registrando donde termina la
+ * cabecera de comentarios y el ancho/alto de las filas de datos.
+ * Las filas vacias finales no cuentan en el alto.
+ */
+static int measure_cells(FILE *f, long *offset, int64_t *width, int64_t *height) {
+    int c;
+    int64_t col = 0, row = 0, w = 0, h = 0;
+    int comment = 0, in_header = 1;
+    long line_start = ftell(f);
+    while ((c = fgetc(f)) != EOF) {
+        if (c == '\n') {
+            if (!comment && !in_header) row++;
+            comment = 0;
+            col = 0;
+            if (in_header) line_start = ftell(f);
+            continue;
+        }
+        if (comment) continue;
+        if (col == 0 && c == '!') {
+            comment = 1;
+            continue;
+        }
+        if (c == 'O' || c == '*' || c == '.') {
+            in_header = 0;
+            col++;
+            if (col > w) w = col;
+            if (row + 1 > h) h = row + 1;
+        } else if (c != '\r' && c != ' ' && c != '\t') {
+            return 0;
+        }
+    }
+    *offset = line_start;
+    *width = w;
+    *height = h;
+    return !ferror(f);
+}
+
+/*
+ * measure_mc — Busca el inicio de los datos y el nivel de la raiz (la
+ * ultima linea de nodo u hoja). Solo se lee el primer numero de cada
+ * linea, sin construir el quadtree.
+ */
+static int measure_mc(FILE *f, long *offset, int64_t *width, int64_t *height) {
+    char line[MC_LINE_MAX];
+    long pos = ftell(f);
+    int level = -1;
+    *offset = -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] != '[' && line[0] != '#') {
+            if (*offset < 0) *offset = pos;
+            if (line[0] == '.' || line[0] == '*' || line[0] == '$')
+                level = MC_LEAF_LEVEL;
+            else if (isdigit((unsigned char)line[0]))
+                level = (int)strtoul(line, NULL, 10);
+        }
+        pos = ftell(f);
+    }
+    if (level < MC_LEAF_LEVEL || level > QT_MAX_LEVEL) return 0;
+    *width = *height = (int64_t)1 << level;
+    return !ferror(f);
+}
+
+int pattern_measure(FILE *f, PatternFormat fmt, long *offset,
+                    int64_t *width, int64_t *height) {
+    if (fmt == PATTERN_FMT_CELLS) return measure_cells(f, offset, width, height);
+    if (fmt == PATTERN_FMT_MC) return measure_mc(f, offset, width, height);
+    return 0;
+}
+
+/*
+ * pattern_read_stream — Despacha segun el formato. Para .mc se usa un
+ * QuadTree temporal que se libera tras expandir la parte visible.
+ */
+int pattern_read_stream(FILE *f, PatternFormat fmt, Game *g, int64_t x, int64_t y) {
+    int ok = 0;
+    if (fmt == PATTERN_FMT_CELLS) {
+        /* Un .cells con origen fuera del rango int no puede tocar el grid */
+        if (x > INT_MAX || y > INT_MAX || x < -INT_MAX || y < -INT_MAX) return 1;
+        ok = pattern_read_cells(f, g, (int)x, (int)y);
+    } else if (fmt == PATTERN_FMT_MC) {
+        QuadTree *qt = qt_create();
+        QNode *root;
+        if (qt && pattern_read_mc(f, qt, &root)) {
+            qt_to_game(root, g, x, y);
+            ok = 1;
+        }
+        qt_destroy(qt);
+    }
+    return ok;
+}
+
+/*
+ * pattern_load_file — Abre el archivo y delega en pattern_read_stream.
+ */
+int pattern_load_file(Game *g, const char *path, int x, int y) {
+    PatternFormat fmt = pattern_format_from_path(path);
+    FILE *f;
+    int ok;
+    if (fmt == PATTERN_FMT_UNKNOWN) return 0;
+    f = fopen(path, "rb");
+    if (!f) return 0;
+    ok = pattern_read_stream(f, fmt, g, x, y);
+    fclose(f);
+    return ok;
+}
+
+/*
+ * pattern_file_origin — Recorre la cabecera hasta el primer dato
+ * buscando "!Origin: x y" en un .cells o "#C Origin: x y" en un .mc.
+ * La cabecera de un .mc son las lineas que empiezan con '[' o '#'.
+ */
+int pattern_file_origin(const char *path, int *x, int *y) {
+    char line[256];
+    PatternFormat fmt = pattern_format_from_path(path);
+    const char *tag = fmt == PATTERN_FMT_MC ? "#C Origin: %ld %ld" : "!Origin: %ld %ld";
+    FILE *f;
+    int found = 0;
+    if (fmt == PATTERN_FMT_UNKNOWN) return 0;
+    f = fopen(path, "rb");
+    if (!f) return 0;
+    while (!found && fgets(line, sizeof(line), f) &&
+           (fmt == PATTERN_FMT_MC ? line[0] == '[' || line[0] == '#' : line[0] == '!')) {
+        long ox, oy;
+        if (sscanf(line, tag, &ox, &oy) == 2 &&
+            ox >= -INT_MAX && ox <= INT_MAX && oy >= -INT_MAX && oy <= INT_MAX) {
+            *x = (int)ox;
+            *y = (int)oy;
+            found = 1;
+        }
+        /* Un comentario mas largo que el buffer sigue en la proxima lectura */
+        while (!strchr(line, '\n') && fgets(line, sizeof(line), f))
+            ;
+    }
+    fclose(f);
+    return found;
+}
+
+/*
+ * pattern_save_file — Escribe el grid completo. Para .mc se construye
+ * el quadtree del grid con el origen en la celda (0, 0), de modo que
+ * cargarlo con pattern_load_file en (0, 0) reproduce el grid exacto; la
+ * cabecera lo anota para pattern_file_origin.
+ */
+int pattern_save_file(Game *g, const char *path) {
+    PatternFormat fmt = pattern_format_from_path(path);
+    FILE *f;
+    int ok = 0;
+    if (fmt == PATTERN_FMT_UNKNOWN) return 0;
+    f = fopen(path, "wb");
+    if (!f) return 0;
+    if (fmt == PATTERN_FMT_CELLS) {
+        ok = pattern_write_cells(f, g, NULL);
+    } else {
+        QuadTree *qt = qt_create();
+        QNode *root = qt ? qt_from_game(qt, g) : NULL;
+        ok = root && write_mc(f, qt, root, 1);
+        qt_destroy(qt);
+    }
+    if (fclose(f) != 0) ok = 0;
+    return ok;
+}
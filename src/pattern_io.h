@@ -0,0 +1,119 @@
+/*
+ * pattern_io.h — Lectura y escritura de patrones en archivos.
+ *
+ * Formatos soportados:
+ *   - Plaintext (.cells): una fila por linea, 'O' (o '*') viva y '.' muerta.
+ *     Las lineas que empiezan con '!' son comentarios; "!Name: X" da el
+ *     nombre del patron. Se carga directamente en el grid plano de Game.
+ *   - Macrocell (.mc): serializacion del quadtree canonico de Golly. Cada
+ *     linea es una hoja de 8x8 o un nodo "nivel nw ne sw se" que referencia
+ *     lineas anteriores. Se carga en un QuadTree sin expandirlo, porque
+ *     puede describir patrones mucho mas grandes que la memoria.
+ *
+ * Todas las funciones de lectura retornan 1 en exito y 0 si el archivo
+ * esta mal formado o falla una alocacion, siguiendo la convencion de
+ * pattern_from_name.
+ */
+
+#ifndef PATTERN_IO_H
+#define PATTERN_IO_H
+
+#include <stdio.h>      /* FILE */
+#include "game.h"
+#include "quadtree.h"
+
+/*
+ * PatternFormat — Formato de archivo, deducido de la extension.
+ */
+typedef enum {
+    PATTERN_FMT_UNKNOWN,
+    PATTERN_FMT_CELLS,
+    PATTERN_FMT_MC
+} PatternFormat;
+
+/*
+ * pattern_format_from_path — Deduce el formato por la extension del path
+ * (".cells" o ".mc", sin distinguir mayusculas).
+ */
+PatternFormat pattern_format_from_path(const char *path);
+
+/*
+ * pattern_read_cells — Lee un .cells y activa sus celdas en el Game con
+ * la esquina superior izquierda del patron en (x, y). Las celdas que
+ * caen fuera del grid se ignoran.
+ */
+int pattern_read_cells(FILE *f, Game *g, int x, int y);
+
+/*
+ * pattern_write_cells — Escribe el bounding box de las celdas vivas del
+ * Game en formato .cells. name (puede ser NULL) se emite como "!Name:",
+ * y la celda del grid donde empieza el bounding box como "!Origin: x y"
+ * (un comentario: otros lectores lo ignoran).
+ * Retorna 1 en exito, 0 si falla la escritura.
+ */
+int pattern_write_cells(FILE *f, Game *g, const char *name);
+
+/*
+ * pattern_read_mc — Lee un .mc en el QuadTree dado y escribe la raiz en
+ * *root. No expande el patron: la memoria usada es proporcional a la
+ * cantidad de lineas del archivo.
+ */
+int pattern_read_mc(FILE *f, QuadTree *qt, QNode **root);
+
+/*
+ * pattern_write_mc — Serializa el quadtree con raiz root en formato .mc.
+ * Los subarboles compartidos se escriben una sola vez.
+ * Retorna 1 en exito, 0 si falla la escritura.
+ */
+int pattern_write_mc(FILE *f, QuadTree *qt, QNode *root);
+
+/*
+ * pattern_measure — Analiza un archivo desde la posicion actual sin
+ * cargarlo en un grid.
+ *
+ * *offset — Byte donde empiezan los datos (tras cabecera y comentarios),
+ *           para que una carga posterior pueda hacer fseek directo.
+ * *width, *height — Bounding box del patron. Para .cells es el exacto;
+ *           para .mc es el cuadrado de la raiz (2^nivel), centrado en el
+ *           origen del quadtree.
+ * Retorna 1 en exito, 0 si el contenido es invalido.
+ */
+int pattern_measure(FILE *f, PatternFormat fmt, long *offset,
+                    int64_t *width, int64_t *height);
+
+/*
+ * pattern_read_stream — Carga en el Game el patron que empieza en la
+ * posicion actual de f, con la misma semantica de (x, y) que
+ * pattern_load_file. Las coordenadas son de 64 bits porque el origen de
+ * un .mc enorme puede quedar muy lejos del grid.
+ */
+int pattern_read_stream(FILE *f, PatternFormat fmt, Game *g, int64_t x, int64_t y);
+
+/*
+ * pattern_load_file — Carga un archivo de patron en el Game.
+ *
+ * Para .cells, (x, y) es la esquina superior izquierda del patron.
+ * Para .mc, (x, y) es la celda donde queda el origen del quadtree y solo
+ * se expande la parte que intersecta el grid.
+ * Retorna 1 en exito, 0 si el archivo no existe, el formato es
+ * desconocido o el contenido es invalido.
+ */
+int pattern_load_file(Game *g, const char *path, int x, int y);
+
+/*
+ * pattern_file_origin — Si la cabecera de path trae un origen, como los
+ * archivos que escribe pattern_save_file ("!Origin: x y" en un .cells,
+ * "#C Origin: x y" en un .mc), escribe esa posicion en *x, *y y retorna
+ * 1. Cargar el archivo ahi con pattern_load_file reproduce las celdas
+ * donde estaban al guardarlo. Retorna 0 si no hay origen o el archivo
+ * no puede leerse.
+ */
+int pattern_file_origin(const char *path, int *x, int *y);
+
+/*
+ * pattern_save_file — Guarda el estado del Game en el formato indicado
+ * por la extension de path. Retorna 1 en exito, 0 si falla.
+ */
+int pattern_save_file(Game *g, const char *path);
+
+#endif
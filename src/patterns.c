@@ -11,24 +11,35 @@
  * para mantener la organizacion interna del modulo.
  */
 
-#include <string.h>  /* strcmp */
+#include <string.h>  /* strcmp, memset */
 #include "patterns.h"
 
+/* Lado maximo del bounding box de un predefinido (gosper mide 36x9) */
+#define PATTERN_MAX_SIDE 64
+
 /*
  * set_cells — Funcion auxiliar que activa un conjunto de celdas.
  *
  * Recibe un array de pares [x, y] relativos y un offset (ox, oy).
- * Itera sobre las coordenadas y llama a game_set_cell para cada una.
+ * Marca las coordenadas en un bitmap del bounding box del patron y lo
+ * estampa con game_write_bits en modo OR: una copia por fila en lugar de
+ * una llamada con verificacion de limites por celda.
  *
  * El tipo const int (*coords)[2] es un puntero a arrays de 2 enteros,
  * lo que permite pasar arrays bidimensionales de tamanio variable.
  * count indica cuantos pares contiene el array.
  */
 static void set_cells(Game *g, int ox, int oy, const int (*coords)[2], int count) {
-    int i;
+    unsigned char bits[PATTERN_MAX_SIDE][PATTERN_MAX_SIDE / 8];
+    int i, w = 0, h = 0;
+    memset(bits, 0, sizeof(bits));
     for (i = 0; i < count; i++) {
-        game_set_cell(g, ox + coords[i][0], oy + coords[i][1], 1);
+        int x = coords[i][0], y = coords[i][1];
+        bits[y][x >> 3] |= (unsigned char)(1u << (x & 7));
+        if (x >= w) w = x + 1;
+        if (y >= h) h = y + 1;
     }
+    game_write_bits(g, ox, oy, w, h, &bits[0][0], sizeof(bits[0]), GAME_BLEND_OR);
 }
 
 /*
@@ -169,22 +180,43 @@ void pattern_load(Game *g, PatternType type, int x, int y) {
     }
 }
 
+/*
+ * builtins — Tabla de patrones predefinidos con su bounding box.
+ *
+ * "gosper" y "gosper_gun" son alias de PATTERN_GOSPER_GUN, facilitando
+ * su uso desde la linea de comandos.
+ */
+static const PatternInfo builtins[] = {
+    { "glider",     PATTERN_GLIDER,      3,  3 },
+    { "blinker",    PATTERN_BLINKER,     3,  1 },
+    { "toad",       PATTERN_TOAD,        4,  2 },
+    { "beacon",     PATTERN_BEACON,      4,  4 },
+    { "pulsar",     PATTERN_PULSAR,     13, 13 },
+    { "gosper",     PATTERN_GOSPER_GUN, 36,  9 },
+    { "gosper_gun", PATTERN_GOSPER_GUN, 36,  9 }
+};
+
+const PatternInfo *pattern_builtins(int *count) {
+    *count = (int)(sizeof(builtins) / sizeof(builtins[0]));
+    return builtins;
+}
+
 /*
  * pattern_from_name — Traduce un string a PatternType.
  *
- * Compara el nombre recibido contra los identificadores conocidos
- * usando strcmp. Acepta "gosper" y "gosper_gun" como alias para
- * PATTERN_GOSPER_GUN, facilitando su uso desde la linea de comandos.
+ * Recorre la tabla de predefinidos comparando con strcmp. Para
+ * resolver nombres en O(1) junto con bibliotecas de archivos se usa
+ * el registro de registry.h, que indexa esta misma tabla.
  *
  * Retorna 1 y escribe en *out si hay match; retorna 0 si no.
  */
 int pattern_from_name(const char *name, PatternType *out) {
-    if (strcmp(name, "glider") == 0)     { *out = PATTERN_GLIDER;     return 1; }
-    if (strcmp(name, "blinker") == 0)    { *out = PATTERN_BLINKER;    return 1; }
-    if (strcmp(name, "toad") == 0)       { *out = PATTERN_TOAD;       return 1; }
-    if (strcmp(name, "beacon") == 0)     { *out = PATTERN_BEACON;     return 1; }
-    if (strcmp(name, "pulsar") == 0)     { *out = PATTERN_PULSAR;     return 1; }
-    if (strcmp(name, "gosper") == 0)     { *out = PATTERN_GOSPER_GUN; return 1; }
-    if (strcmp(name, "gosper_gun") == 0) { *out = PATTERN_GOSPER_GUN; return 1; }
+    int i;
+    for (i = 0; i < (int)(sizeof(builtins) / sizeof(builtins[0])); i++) {
+        if (strcmp(name, builtins[i].name) == 0) {
+            *out = builtins[i].type;
+            return 1;
+        }
+    }
     return 0;
 }
@@ -35,6 +35,29 @@ typedef enum {
     PATTERN_GOSPER_GUN
 } PatternType;
 
+/*
+ * PatternInfo — Descripcion de un patron predefinido.
+ *
+ * name   — Nombre usado en --pattern (los alias tienen su propia entrada).
+ * type   — Valor del enum que pattern_load sabe colocar.
+ * width  — Ancho del bounding box del patron en celdas.
+ * height — Alto del bounding box del patron en celdas.
+ */
+typedef struct {
+    const char *name;
+    PatternType type;
+    int width;
+    int height;
+} PatternInfo;
+
+/*
+ * pattern_builtins — Tabla de los patrones predefinidos (incluye alias).
+ * Escribe la cantidad de entradas en *count. La tabla es estatica y
+ * permite registrar los predefinidos en el mismo registro que los
+ * patrones de archivo (ver registry.h).
+ */
+const PatternInfo *pattern_builtins(int *count);
+
 /*
  * pattern_load — Coloca el patron especificado en la posicion (x, y) del grid.
  * Las coordenadas (x, y) corresponden a la esquina superior izquierda
@@ -0,0 +1,136 @@
+/*
+ * perfcount.c — Implementacion de perfcount.h sobre perf_event_open(2).
+ *
+ * Cada evento es un file descriptor independiente (no un grupo): con
+ * herencia a threads hijos el kernel no permite leer grupos, y eventos
+ * sueltos dejan abrir los que existan aunque falte alguno. Si hay mas
+ * eventos que registros de la PMU el kernel los multiplexa en el tiempo;
+ * cada lectura trae el tiempo habilitado y el tiempo realmente contado,
+ * y la cuenta se escala por su cociente.
+ */
+
+#define _DEFAULT_SOURCE  /* syscall */
+
+#include <stdlib.h>  /* malloc, free */
+#include "perfcount.h"
+
+static const char *const event_names[PERF_EVENT_COUNT] = {
+    "cycles", "instructions", "l1d-misses", "llc-misses", "branch-misses"
+};
+
+const char *perfcount_name(PerfEvent event) {
+    return event_names[event];
+}
+
+#ifdef __linux__
+
+#include <string.h>           /* memset */
+#include <unistd.h>           /* syscall, read, close */
+#include <sys/ioctl.h>        /* ioctl */
+#include <sys/syscall.h>      /* SYS_perf_event_open */
+#include <linux/perf_event.h> /* perf_event_attr, PERF_* */
+
+struct PerfCounters {
+    int fds[PERF_EVENT_COUNT];
+};
+
+/*
+ * open_event — Abre un contador del thread actual (y sus hijos futuros)
+ * en cualquier CPU, detenido y solo en modo usuario. Retorna -1 si el
+ * kernel lo rechaza.
+ */
+static int open_event(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+PerfCounters *perfcount_open(void) {
+    PerfCounters *pc = malloc(sizeof(PerfCounters));
+    int i, opened = 0;
+    if (!pc) return NULL;
+    pc->fds[PERF_CYCLES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    pc->fds[PERF_INSTRUCTIONS] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    pc->fds[PERF_L1D_MISSES] = open_event(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+        ((uint64_t)PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    pc->fds[PERF_LLC_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    pc->fds[PERF_BRANCH_MISSES] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    for (i = 0; i < PERF_EVENT_COUNT; i++) opened += pc->fds[i] >= 0;
+    if (!opened) {
+        free(pc);
+        return NULL;
+    }
+    return pc;
+}
+
+void perfcount_close(PerfCounters *pc) {
+    int i;
+    if (!pc) return;
+    for (i = 0; i < PERF_EVENT_COUNT; i++)
+        if (pc->fds[i] >= 0) close(pc->fds[i]);
+    free(pc);
+}
+
+void perfcount_start(PerfCounters *pc) {
+    int i;
+    for (i = 0; i < PERF_EVENT_COUNT; i++) {
+        if (pc->fds[i] < 0) continue;
+        ioctl(pc->fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(pc->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void perfcount_stop(PerfCounters *pc, PerfSample *out) {
+    int i;
+    for (i = 0; i < PERF_EVENT_COUNT; i++)
+        if (pc->fds[i] >= 0) ioctl(pc->fds[i], PERF_EVENT_IOC_DISABLE, 0);
+    for (i = 0; i < PERF_EVENT_COUNT; i++) {
+        /* value, time_enabled, time_running */
+        uint64_t buf[3];
+        out->values[i] = 0;
+        out->available[i] = 0;
+        if (pc->fds[i] < 0 || read(pc->fds[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf))
+            continue;
+        out->available[i] = 1;
+        if (buf[2] && buf[2] < buf[1])
+            out->values[i] = (uint64_t)((double)buf[0] * (double)buf[1] / (double)buf[2]);
+        else
+            out->values[i] = buf[0];
+    }
+}
+
+#else
+
+/* Fuera de Linux no hay perf_event_open: nunca se abren contadores */
+
+PerfCounters *perfcount_open(void) {
+    return NULL;
+}
+
+void perfcount_close(PerfCounters *pc) {
+    (void)pc;
+}
+
+void perfcount_start(PerfCounters *pc) {
+    (void)pc;
+}
+
+void perfcount_stop(PerfCounters *pc, PerfSample *out) {
+    int i;
+    (void)pc;
+    for (i = 0; i < PERF_EVENT_COUNT; i++) {
+        out->values[i] = 0;
+        out->available[i] = 0;
+    }
+}
+
+#endif
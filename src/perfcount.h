@@ -0,0 +1,78 @@
+/*
+ * perfcount.h — Contadores de hardware de la CPU (perf_event_open).
+ *
+ * El tiempo de pared no explica por que un kernel es mas lento que
+ * otro. Estos contadores miden, para un tramo de codigo, ciclos,
+ * instrucciones (y con ellos IPC), fallos de cache L1 de datos y del
+ * ultimo nivel, y branches mal predichos. El corredor sin ventana los
+ * normaliza por celda calculada para comparar engines.
+ *
+ * Solo existe en Linux. En otros sistemas, o si el kernel no los
+ * permite (perf_event_paranoid, contenedores, maquinas virtuales sin
+ * PMU), perfcount_open retorna NULL y el llamador sigue sin ellos.
+ *
+ * Los contadores se abren con herencia: cuentan el thread que llama y
+ * los threads que cree despues (los workers de un pool creado tras
+ * perfcount_open), no los que ya existian.
+ */
+
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdint.h>  /* uint64_t */
+
+/*
+ * PerfEvent — Eventos medidos, en el orden de PerfSample.values.
+ */
+typedef enum {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_L1D_MISSES,
+    PERF_LLC_MISSES,
+    PERF_BRANCH_MISSES,
+    PERF_EVENT_COUNT
+} PerfEvent;
+
+/*
+ * PerfSample — Resultado de un tramo medido.
+ *
+ * values    — Cuenta de cada evento, escalada si el kernel tuvo que
+ *             multiplexar los contadores (mas eventos que registros).
+ * available — 1 si el evento pudo abrirse; si no, su valor es 0.
+ */
+typedef struct {
+    uint64_t values[PERF_EVENT_COUNT];
+    int available[PERF_EVENT_COUNT];
+} PerfSample;
+
+typedef struct PerfCounters PerfCounters;
+
+/*
+ * perfcount_open — Abre los contadores, detenidos. Retorna NULL si no
+ * pudo abrirse ninguno (o fuera de Linux). Los eventos que la CPU no
+ * tenga quedan marcados como no disponibles.
+ */
+PerfCounters *perfcount_open(void);
+
+/*
+ * perfcount_close — Cierra los contadores. Acepta NULL.
+ */
+void perfcount_close(PerfCounters *pc);
+
+/*
+ * perfcount_start — Pone los contadores en cero y los arranca.
+ */
+void perfcount_start(PerfCounters *pc);
+
+/*
+ * perfcount_stop — Detiene los contadores y escribe las cuentas desde
+ * el ultimo perfcount_start en *out.
+ */
+void perfcount_stop(PerfCounters *pc, PerfSample *out);
+
+/*
+ * perfcount_name — Nombre corto del evento para reportes.
+ */
+const char *perfcount_name(PerfEvent event);
+
+#endif
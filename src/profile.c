@@ -0,0 +1,134 @@
+/*
+ * profile.c — Histogramas de latencia de profile.h.
+ *
+ * Mapeo valor -> bucket (PROFILE_SUB = 16 buckets por potencia de 2):
+ *   - Valores menores a 16 ns tienen un bucket cada uno (0..15).
+ *   - Para v >= 16, con e = posicion del bit mas alto (4..63), los 4
+ *     bits siguientes al mas alto eligen uno de 16 sub-buckets:
+ *     bucket = (e - 3) * 16 + ((v >> (e - 4)) & 15).
+ * El bucket guarda todos los valores que comparten el bit alto y esos 4
+ * bits, un rango de ancho v/16 como maximo.
+ *
+ * Se usa clock_gettime(CLOCK_MONOTONIC), que en Linux y macOS se lee sin
+ * syscall (vDSO / commpage) en unas decenas de nanosegundos, en lugar
+ * de rdtsc: no hace falta calibrar la frecuencia del TSC ni depender
+ * de x86.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime, CLOCK_MONOTONIC */
+
+#include <string.h>  /* memset */
+#include <time.h>    /* clock_gettime */
+#include "profile.h"
+
+#ifdef GOL_PROFILE
+
+/* Buckets por potencia de 2 y total de buckets por histograma */
+#define PROFILE_SUB 16
+#define PROFILE_BUCKETS ((64 - 3) * PROFILE_SUB)
+
+/*
+ * Histogram — Contadores de una zona.
+ */
+typedef struct {
+    uint64_t counts[PROFILE_BUCKETS];
+    uint64_t samples;
+    uint64_t total;
+    uint64_t max;
+} Histogram;
+
+static Histogram zones[PROFILE_ZONE_COUNT];
+
+static const char *const zone_names[PROFILE_ZONE_COUNT] = {
+    "step", "pass", "events", "render", "io"
+};
+
+/*
+ * high_bit — Posicion del bit mas alto de v (v > 0).
+ */
+static int high_bit(uint64_t v) {
+    int e = 0;
+    while (v >>= 1) e++;
+    return e;
+}
+
+/*
+ * bucket_of — Indice del bucket de v.
+ */
+static int bucket_of(uint64_t v) {
+    int e;
+    if (v < PROFILE_SUB) return (int)v;
+    e = high_bit(v);
+    return (e - 3) * PROFILE_SUB + (int)((v >> (e - 4)) & (PROFILE_SUB - 1));
+}
+
+/*
+ * bucket_high — Mayor valor que cae en el bucket b.
+ */
+static uint64_t bucket_high(int b) {
+    int e, sub;
+    if (b < PROFILE_SUB) return (uint64_t)b;
+    e = b / PROFILE_SUB + 3;
+    sub = b % PROFILE_SUB;
+    return (((uint64_t)(PROFILE_SUB + sub) + 1) << (e - 4)) - 1;
+}
+
+uint64_t profile_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+void profile_record(ProfileZone zone, uint64_t ns) {
+    Histogram *h = &zones[zone];
+    h->counts[bucket_of(ns)]++;
+    h->samples++;
+    h->total += ns;
+    if (ns > h->max) h->max = ns;
+}
+
+void profile_reset(void) {
+    memset(zones, 0, sizeof(zones));
+}
+
+/*
+ * percentile — Valor bajo el cual queda la fraccion q de las muestras:
+ * el extremo superior del bucket que contiene la muestra de rango
+ * ceil(q * samples), acotado por el maximo real.
+ */
+static uint64_t percentile(const Histogram *h, double q) {
+    uint64_t rank = (uint64_t)(q * (double)h->samples + 0.999999);
+    uint64_t seen = 0;
+    int b;
+    if (rank < 1) rank = 1;
+    for (b = 0; b < PROFILE_BUCKETS; b++) {
+        seen += h->counts[b];
+        if (seen >= rank) {
+            uint64_t v = bucket_high(b);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+void profile_report(FILE *f) {
+    int z;
+    fprintf(f, "%-8s %10s %12s %12s %12s %12s\n",
+            "zone", "samples", "p50 us", "p99 us", "max us", "mean us");
+    for (z = 0; z < PROFILE_ZONE_COUNT; z++) {
+        const Histogram *h = &zones[z];
+        if (!h->samples) continue;
+        fprintf(f, "%-8s %10llu %12.1f %12.1f %12.1f %12.1f\n", zone_names[z],
+                (unsigned long long)h->samples,
+                percentile(h, 0.50) / 1e3, percentile(h, 0.99) / 1e3,
+                h->max / 1e3, (double)h->total / (double)h->samples / 1e3);
+    }
+}
+
+#else
+
+void profile_report(FILE *f) {
+    fprintf(f, "Profiling is not compiled in (rebuild with make PROFILE=1)\n");
+}
+
+#endif
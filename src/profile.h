@@ -0,0 +1,90 @@
+/*
+ * profile.h — Instrumentacion de las fases calientes del programa.
+ *
+ * Mide cuanto tarda cada ejecucion de una zona (un paso, un frame de
+ * rendering, el procesamiento de eventos, una escritura de snapshot) y
+ * acumula los tiempos en un histograma por zona, del que se reportan
+ * p50, p99 y maximo.
+ *
+ * Los timers solo existen si se compila con -DGOL_PROFILE (make
+ * PROFILE=1): sin esa flag PROFILE_START y PROFILE_STOP no generan
+ * codigo, asi que el binario normal no paga ni una lectura del reloj.
+ *
+ * Los histogramas son log-lineales, al estilo HDR: cada potencia de 2
+ * se divide en 16 buckets, con lo que cualquier valor entre 1 ns y
+ * 2^64 ns se guarda con un error relativo menor al 6.25% en menos de
+ * 1000 contadores por zona, sin alocar y con un registro O(1).
+ *
+ * Las zonas se registran solo desde el thread principal (el que llama
+ * a game_step, no desde los workers del pool), asi que no hay
+ * sincronizacion.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdio.h>   /* FILE */
+#include <stdint.h>  /* uint64_t */
+
+/*
+ * ProfileZone — Fases medidas.
+ *
+ * PROFILE_STEP   — Una generacion de game_step o universe_step.
+ * PROFILE_PASS   — Una pasada de varias generaciones de
+ *                  GAME_ENGINE_BLOCKED en game_step_n.
+ * PROFILE_EVENTS — Procesamiento de los eventos SDL de un frame.
+ * PROFILE_RENDER — Dibujo del frame y del HUD (con vsync incluye la
+ *                  espera de SDL_RenderPresent).
+ * PROFILE_IO     — Carga de patrones y escritura de snapshots.
+ */
+typedef enum {
+    PROFILE_STEP,
+    PROFILE_PASS,
+    PROFILE_EVENTS,
+    PROFILE_RENDER,
+    PROFILE_IO,
+    PROFILE_ZONE_COUNT
+} ProfileZone;
+
+#ifdef GOL_PROFILE
+
+/*
+ * profile_now — Reloj monotonico en nanosegundos.
+ */
+uint64_t profile_now(void);
+
+/*
+ * profile_record — Agrega una duracion de ns nanosegundos a la zona.
+ */
+void profile_record(ProfileZone zone, uint64_t ns);
+
+/* Abre un timer local t y lo cierra registrando su duracion en zone */
+#define PROFILE_START(t) uint64_t t = profile_now()
+#define PROFILE_STOP(zone, t) profile_record((zone), profile_now() - (t))
+
+/*
+ * profile_reset — Vacia todos los histogramas.
+ */
+void profile_reset(void);
+
+/* Reporte y reinicio automaticos: solo existen en builds con GOL_PROFILE */
+#define PROFILE_REPORT(f) profile_report(f)
+#define PROFILE_RESET() profile_reset()
+
+#else
+
+#define PROFILE_START(t) ((void)0)
+#define PROFILE_STOP(zone, t) ((void)0)
+#define PROFILE_REPORT(f) ((void)0)
+#define PROFILE_RESET() ((void)0)
+
+#endif
+
+/*
+ * profile_report — Escribe en f una linea por zona con muestras, p50,
+ * p99, maximo y promedio. Los histogramas no se reinician. En un build
+ * sin GOL_PROFILE escribe solo un aviso de como habilitarlo.
+ */
+void profile_report(FILE *f);
+
+#endif
@@ -0,0 +1,260 @@
+/*
+ * quadtree.c — Implementacion del quadtree canonico.
+ *
+ * Estructuras internas:
+ *   - Arena: los nodos se alocan en bloques de NODES_PER_BLOCK, enlazados
+ *     en una lista para liberarlos todos juntos.
+ *   - Tabla hash: array de buckets (potencia de 2) con encadenamiento a
+ *     traves de QNode::next. La clave es la tupla de punteros a los hijos;
+ *     como los hijos ya son canonicos, comparar punteros basta para decidir
+ *     igualdad estructural.
+ *   - Cache de nodos vacios por nivel, para que qt_empty sea O(1).
+ */
+
+#include <stdlib.h>  /* malloc, calloc, free */
+#include "quadtree.h"
+
+/* Nodos por bloque de la arena */
+#define NODES_PER_BLOCK 4096
+
+/* Buckets iniciales de la tabla hash (potencia de 2) */
+#define INITIAL_BUCKETS 4096
+
+/*
+ * NodeBlock — Bloque de la arena: cabecera de enlace + nodos.
+ */
+typedef struct NodeBlock {
+    struct NodeBlock *prev;
+    QNode nodes[NODES_PER_BLOCK];
+} NodeBlock;
+
+struct QuadTree {
+    NodeBlock *blocks;      /* Bloque actual (cabeza de la lista) */
+    int block_used;         /* Nodos usados del bloque actual */
+    QNode **buckets;        /* Tabla hash */
+    unsigned long nbuckets; /* Cantidad de buckets (potencia de 2) */
+    unsigned long count;    /* Nodos canonicos alocados */
+    QNode leaves[2];        /* Nivel 0: muerta y viva */
+    QNode *empty[QT_MAX_LEVEL + 1]; /* Cache de nodos vacios por nivel */
+    unsigned epoch;         /* Recorrido actual (ver qt_next_epoch) */
+};
+
+/*
+ * alloc_node — Toma un nodo de la arena, abriendo un bloque nuevo si
+ * el actual esta lleno.
+ */
+static QNode *alloc_node(QuadTree *qt) {
+    if (!qt->blocks || qt->block_used == NODES_PER_BLOCK) {
+        NodeBlock *b = malloc(sizeof(NodeBlock));
+        if (!b) return NULL;
+        b->prev = qt->blocks;
+        qt->blocks = b;
+        qt->block_used = 0;
+    }
+    return &qt->blocks->nodes[qt->block_used++];
+}
+
+/*
+ * hash_children — Mezcla los cuatro punteros hijos en un hash.
+ * Los punteros se desplazan para descartar los bits bajos de alineacion.
+ */
+static unsigned long hash_children(const QNode *nw, const QNode *ne,
+                                   const QNode *sw, const QNode *se) {
+    uint64_t h = (uint64_t)(uintptr_t)nw >> 4;
+    h = h * 0x9E3779B97F4A7C15ull + ((uint64_t)(uintptr_t)ne >> 4);
+    h = h * 0x9E3779B97F4A7C15ull + ((uint64_t)(uintptr_t)sw >> 4);
+    h = h * 0x9E3779B97F4A7C15ull + ((uint64_t)(uintptr_t)se >> 4);
+    return (unsigned long)(h ^ (h >> 29));
+}
+
+/*
+ * grow_table — Duplica la tabla hash y redistribuye las cadenas.
+ * Si la alocacion falla la tabla queda como estaba (solo mas cargada).
+ */
+static void grow_table(QuadTree *qt) {
+    unsigned long nb = qt->nbuckets * 2;
+    QNode **nbk = calloc(nb, sizeof(QNode *));
+    unsigned long i;
+    if (!nbk) return;
+    for (i = 0; i < qt->nbuckets; i++) {
+        QNode *n = qt->buckets[i];
+        while (n) {
+            QNode *next = n->next;
+            unsigned long h = hash_children(n->nw, n->ne, n->sw, n->se) & (nb - 1);
+            n->next = nbk[h];
+            nbk[h] = n;
+            n = next;
+        }
+    }
+    free(qt->buckets);
+    qt->buckets = nbk;
+    qt->nbuckets = nb;
+}
+
+/*
+ * qt_create — Inicializa la tabla hash y los dos nodos hoja.
+ */
+QuadTree *qt_create(void) {
+    QuadTree *qt = calloc(1, sizeof(QuadTree));
+    if (!qt) return NULL;
+    qt->nbuckets = INITIAL_BUCKETS;
+    qt->buckets = calloc(qt->nbuckets, sizeof(QNode *));
+    if (!qt->buckets) {
+        free(qt);
+        return NULL;
+    }
+    qt->leaves[1].population = 1;
+    qt->empty[0] = &qt->leaves[0];
+    return qt;
+}
+
+/*
+ * qt_destroy — Libera los bloques de la arena, la tabla y el contexto.
+ */
+void qt_destroy(QuadTree *qt) {
+    if (!qt) return;
+    while (qt->blocks) {
+        NodeBlock *prev = qt->blocks->prev;
+        free(qt->blocks);
+        qt->blocks = prev;
+    }
+    free(qt->buckets);
+    free(qt);
+}
+
+QNode *qt_leaf(QuadTree *qt, int alive) {
+    return &qt->leaves[alive ? 1 : 0];
+}
+
+/*
+ * qt_node — Busqueda o insercion en la tabla hash (hash-consing).
+ *
+ * La poblacion se calcula una sola vez al crear el nodo, sumando la de
+ * los hijos con saturacion para no desbordar en niveles muy altos.
+ */
+QNode *qt_node(QuadTree *qt, QNode *nw, QNode *ne, QNode *sw, QNode *se) {
+    unsigned long h = hash_children(nw, ne, sw, se) & (qt->nbuckets - 1);
+    QNode *n;
+    for (n = qt->buckets[h]; n; n = n->next) {
+        if (n->nw == nw && n->ne == ne && n->sw == sw && n->se == se)
+            return n;
+    }
+    n = alloc_node(qt);
+    if (!n) return NULL;
+    n->nw = nw;
+    n->ne = ne;
+    n->sw = sw;
+    n->se = se;
+    n->level = nw->level + 1;
+    n->population = nw->population;
+    n->population += ne->population;
+    if (n->population < ne->population) n->population = UINT64_MAX;
+    n->population += sw->population;
+    if (n->population < sw->population) n->population = UINT64_MAX;
+    n->population += se->population;
+    if (n->population < se->population) n->population = UINT64_MAX;
+    n->tag = 0;
+    n->epoch = 0;
+    n->next = qt->buckets[h];
+    qt->buckets[h] = n;
+    if (++qt->count > qt->nbuckets) grow_table(qt);
+    return n;
+}
+
+/*
+ * qt_empty — Construye (una vez) y cachea el nodo vacio de cada nivel.
+ */
+QNode *qt_empty(QuadTree *qt, int level) {
+    if (level < 0 || level > QT_MAX_LEVEL) return NULL;
+    if (!qt->empty[level]) {
+        QNode *c = qt_empty(qt, level - 1);
+        if (!c) return NULL;
+        qt->empty[level] = qt_node(qt, c, c, c, c);
+    }
+    return qt->empty[level];
+}
+
+unsigned long qt_node_count(const QuadTree *qt) {
+    return qt->count;
+}
+
+unsigned qt_next_epoch(QuadTree *qt) {
+    return ++qt->epoch;
+}
+
+/*
+ * qt_get_cell — Descenso iterativo eligiendo el cuadrante que contiene
+ * (x, y) y restando el offset del cuadrante en cada nivel.
+ */
+int qt_get_cell(const QNode *n, int64_t x, int64_t y) {
+    int64_t size = (int64_t)1 << n->level;
+    if (x < 0 || y < 0 || x >= size || y >= size) return 0;
+    while (n->level > 0) {
+        int64_t half = (int64_t)1 << (n->level - 1);
+        if (n->population == 0) return 0;
+        if (y < half) {
+            n = x < half ? n->nw : n->ne;
+        } else {
+            n = x < half ? n->sw : n->se;
+            y -= half;
+        }
+        if (x >= half) x -= half;
+    }
+    return n->population != 0;
+}
+
+/*
+ * build_from_game — Construye el nodo de nivel level cuya esquina
+ * superior izquierda es la celda (x0, y0) del grid. Las regiones que
+ * quedan fuera del grid se resuelven directamente con qt_empty.
+ */
+static QNode *build_from_game(QuadTree *qt, Game *g, int level, int64_t x0, int64_t y0) {
+    if (x0 >= g->width || y0 >= g->height) return qt_empty(qt, level);
+    if (level == 0) return qt_leaf(qt, game_get_cell(g, (int)x0, (int)y0));
+    int64_t half = (int64_t)1 << (level - 1);
+    QNode *nw = build_from_game(qt, g, level - 1, x0, y0);
+    QNode *ne = build_from_game(qt, g, level - 1, x0 + half, y0);
+    QNode *sw = build_from_game(qt, g, level - 1, x0, y0 + half);
+    QNode *se = build_from_game(qt, g, level - 1, x0 + half, y0 + half);
+    if (!nw || !ne || !sw || !se) return NULL;
+    return qt_node(qt, nw, ne, sw, se);
+}
+
+/*
+ * qt_from_game — Elige el nivel minimo cuya mitad cubre el grid y ubica
+ * el grid en el cuadrante sureste, de modo que la celda (x, y) quede en
+ * la coordenada (x, y) del quadtree.
+ */
+QNode *qt_from_game(QuadTree *qt, Game *g) {
+    int level = 1;
+    int side = g->width > g->height ? g->width : g->height;
+    while (((int64_t)1 << (level - 1)) < side) level++;
+    QNode *se = build_from_game(qt, g, level - 1, 0, 0);
+    QNode *e = qt_empty(qt, level - 1);
+    if (!se || !e) return NULL;
+    return qt_node(qt, e, e, e, se);
+}
+
+/*
+ * expand_into — Recorrido recursivo que poda subarboles vacios y los
+ * que no intersectan el grid. (x, y) es la esquina del nodo en el grid.
+ */
+static void expand_into(const QNode *n, Game *g, int64_t x, int64_t y) {
+    int64_t size = (int64_t)1 << n->level;
+    if (n->population == 0) return;
+    if (x >= g->width || y >= g->height || x + size <= 0 || y + size <= 0) return;
+    if (n->level == 0) {
+        game_set_cell(g, (int)x, (int)y, 1);
+        return;
+    }
+    int64_t half = size / 2;
+    expand_into(n->nw, g, x, y);
+    expand_into(n->ne, g, x + half, y);
+    expand_into(n->sw, g, x, y + half);
+    expand_into(n->se, g, x + half, y + half);
+}
+
+void qt_to_game(const QNode *root, Game *g, int64_t ox, int64_t oy) {
+    int64_t half = root->level > 0 ? (int64_t)1 << (root->level - 1) : 0;
+    expand_into(root, g, ox - half, oy - half);
+}
@@ -0,0 +1,117 @@
+/*
+ * quadtree.h — Quadtree canonico (hash-consed) para patrones enormes.
+ *
+ * Un nodo de nivel k representa un cuadrado de 2^k x 2^k celdas dividido
+ * en cuatro hijos de nivel k-1 (nw, ne, sw, se). El nivel 0 son las
+ * celdas individuales: solo existen dos nodos de nivel 0, muerta y viva.
+ *
+ * Todos los nodos pasan por una tabla hash que garantiza que dos
+ * subarboles identicos son el mismo puntero (hash-consing). Gracias a
+ * esto un patron con mucha repeticion (como los del formato Macrocell)
+ * ocupa memoria proporcional a sus subpatrones distintos, no a su area:
+ * un quadtree de nivel 40 cubre 2^80 celdas y puede cargarse sin
+ * expandirlo nunca al array plano de Game.
+ *
+ * Convencion de coordenadas (la de Golly): la raiz de nivel L cubre el
+ * rango [-2^(L-1), 2^(L-1)) en ambos ejes, con y creciendo hacia abajo.
+ */
+
+#ifndef QUADTREE_H
+#define QUADTREE_H
+
+#include <stdint.h>  /* int64_t, uint64_t */
+#include "game.h"
+
+/* Nivel maximo soportado: las coordenadas de celda caben en int64_t */
+#define QT_MAX_LEVEL 62
+
+/*
+ * QNode — Nodo inmutable del quadtree.
+ *
+ * nw, ne, sw, se — Hijos de nivel level-1 (NULL en nivel 0).
+ * next           — Encadenamiento en la tabla hash del QuadTree.
+ * population     — Celdas vivas del subarbol (satura en UINT64_MAX).
+ * level          — Nivel del nodo: lado de 2^level celdas.
+ * tag            — Campo auxiliar para recorridos (ver qt_next_epoch).
+ * epoch          — Recorrido al que pertenece el valor de tag.
+ */
+typedef struct QNode {
+    struct QNode *nw, *ne, *sw, *se;
+    struct QNode *next;
+    uint64_t population;
+    int level;
+    unsigned long tag;
+    unsigned epoch;
+} QNode;
+
+/*
+ * QuadTree — Contexto duenio de todos los nodos y de la tabla hash.
+ *
+ * Los nodos se alocan en bloques (arena) y se liberan todos juntos en
+ * qt_destroy; no hay liberacion individual porque un nodo canonico puede
+ * estar compartido por cualquier cantidad de padres.
+ */
+typedef struct QuadTree QuadTree;
+
+/*
+ * qt_create — Crea un contexto vacio. Retorna NULL si falla la alocacion.
+ */
+QuadTree *qt_create(void);
+
+/*
+ * qt_destroy — Libera todos los nodos y el contexto. Acepta NULL.
+ */
+void qt_destroy(QuadTree *qt);
+
+/*
+ * qt_leaf — Nodo de nivel 0: la celda muerta (alive == 0) o viva.
+ */
+QNode *qt_leaf(QuadTree *qt, int alive);
+
+/*
+ * qt_node — Nodo canonico con los cuatro hijos dados (mismo nivel).
+ * Si ya existe un nodo identico lo reutiliza. Retorna NULL si falla
+ * la alocacion.
+ */
+QNode *qt_node(QuadTree *qt, QNode *nw, QNode *ne, QNode *sw, QNode *se);
+
+/*
+ * qt_empty — Nodo canonico completamente muerto del nivel dado.
+ */
+QNode *qt_empty(QuadTree *qt, int level);
+
+/*
+ * qt_node_count — Cantidad de nodos canonicos distintos alocados.
+ */
+unsigned long qt_node_count(const QuadTree *qt);
+
+/*
+ * qt_next_epoch — Inicia un recorrido nuevo: todos los campos tag de los
+ * nodos quedan invalidados sin tocarlos (un nodo tiene tag valido solo si
+ * su epoch coincide con el valor retornado).
+ */
+unsigned qt_next_epoch(QuadTree *qt);
+
+/*
+ * qt_get_cell — Estado de la celda (x, y) relativa a la esquina superior
+ * izquierda del nodo. Coordenadas fuera del nodo retornan 0.
+ */
+int qt_get_cell(const QNode *n, int64_t x, int64_t y);
+
+/*
+ * qt_from_game — Construye un quadtree con el contenido del Game.
+ * La celda (x, y) del grid queda en la coordenada (x, y) del quadtree,
+ * es decir, dentro del cuadrante sureste de la raiz. Retorna la raiz
+ * o NULL si falla la alocacion.
+ */
+QNode *qt_from_game(QuadTree *qt, Game *g);
+
+/*
+ * qt_to_game — Expande en el Game la parte del quadtree que cae dentro
+ * del grid. El origen (0, 0) del quadtree se ubica en la celda (ox, oy).
+ * Solo se visitan los subarboles no vacios que intersectan el grid, por
+ * lo que el costo depende del area visible y no del tamanio del patron.
+ */
+void qt_to_game(const QNode *root, Game *g, int64_t ox, int64_t oy);
+
+#endif
@@ -0,0 +1,446 @@
+/*
+ * registry.c — Implementacion del registro de patrones.
+ *
+ * Tabla hash con direccionamiento abierto (sondeo lineal) sobre un array
+ * de PatternEntry cuya capacidad es potencia de 2; un slot con name NULL
+ * esta libre. La tabla crece al superar el 70% de ocupacion.
+ *
+ * Formato del indice en disco (texto, una entrada por linea):
+ *
+ *   dosdoseis-index 3 <mtime del directorio>
+ *   <c|m> <tamanio> <mtime> <offset> <ancho> <alto> <nombre de archivo>
+ *
+ * Los mtime van en nanosegundos: con segundos, un archivo agregado en el
+ * mismo segundo en que se escribio el indice pasaria inadvertido. El
+ * nombre de archivo va al final para admitir espacios. El mtime de la
+ * cabecera tiene ancho fijo para poder reescribirlo en su lugar: crear el
+ * indice modifica el propio directorio, asi que tras el rename se vuelve a
+ * leer el mtime y se actualiza la cabecera.
+ *
+ * El mtime del directorio solo cambia al agregar, borrar o renombrar
+ * archivos; editar uno en su lugar no lo altera. Por eso cada linea
+ * guarda ademas el tamanio y el mtime del archivo al medirlo. Al
+ * arrancar no se hace stat de cada archivo: registry_load compara solo
+ * la entrada elegida y, si no coincide, la vuelve a medir y reescribe el
+ * indice.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* opendir, readdir, stat, st_mtim */
+#define _DARWIN_C_SOURCE         /* st_mtimespec en macOS */
+
+#include <stdio.h>      /* FILE, fopen, fprintf, snprintf, rename */
+#include <stdlib.h>     /* malloc, calloc, free, strtol */
+#include <string.h>     /* strcmp, strncmp, strlen, memcpy, strrchr, strchr */
+#include <limits.h>     /* INT_MAX */
+#include <dirent.h>     /* opendir, readdir, closedir */
+#include <sys/stat.h>   /* stat */
+#include "registry.h"
+
+/* Capacidad inicial de la tabla (potencia de 2) */
+#define INITIAL_SLOTS 64
+
+/* Version del formato del indice; cambiarla invalida indices viejos */
+#define INDEX_VERSION 3
+
+/* Longitud maxima de una linea del indice */
+#define INDEX_LINE_MAX 4096
+
+struct PatternRegistry {
+    PatternEntry *slots;
+    int cap;
+    int count;
+};
+
+/*
+ * dup_string — Copia un string en memoria propia (strdup no es C99).
+ */
+static char *dup_string(const char *s) {
+    size_t n = strlen(s) + 1;
+    char *d = malloc(n);
+    if (d) memcpy(d, s, n);
+    return d;
+}
+
+/*
+ * hash_name — FNV-1a de 32 bits sobre el nombre.
+ */
+static unsigned hash_name(const char *s) {
+    unsigned h = 2166136261u;
+    while (*s) {
+        h ^= (unsigned char)*s++;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/*
+ * find_slot — Slot que contiene name, o el primer slot libre de su
+ * secuencia de sondeo.
+ */
+static PatternEntry *find_slot(PatternEntry *slots, int cap, const char *name) {
+    unsigned i = hash_name(name) & (unsigned)(cap - 1);
+    while (slots[i].name && strcmp(slots[i].name, name) != 0)
+        i = (i + 1) & (unsigned)(cap - 1);
+    return &slots[i];
+}
+
+/*
+ * grow — Duplica la capacidad y reubica las entradas (moviendo los
+ * punteros a strings, sin copiarlos).
+ */
+static int grow(PatternRegistry *reg) {
+    int ncap = reg->cap * 2;
+    PatternEntry *ns = calloc((size_t)ncap, sizeof(PatternEntry));
+    int i;
+    if (!ns) return 0;
+    for (i = 0; i < reg->cap; i++) {
+        if (reg->slots[i].name)
+            *find_slot(ns, ncap, reg->slots[i].name) = reg->slots[i];
+    }
+    free(reg->slots);
+    reg->slots = ns;
+    reg->cap = ncap;
+    return 1;
+}
+
+/*
+ * insert — Inserta o reemplaza la entrada de e->name. El registro toma
+ * posesion de e->name y e->path. Retorna 0 si falla la alocacion (en
+ * cuyo caso los strings se liberan).
+ */
+static int insert(PatternRegistry *reg, PatternEntry *e) {
+    PatternEntry *slot;
+    if ((reg->count + 1) * 10 > reg->cap * 7 && !grow(reg)) {
+        free(e->name);
+        free(e->path);
+        return 0;
+    }
+    slot = find_slot(reg->slots, reg->cap, e->name);
+    if (slot->name) {
+        free(slot->name);
+        free(slot->path);
+    } else {
+        reg->count++;
+    }
+    *slot = *e;
+    return 1;
+}
+
+/*
+ * registry_create — Tabla inicial + registro de los predefinidos.
+ */
+PatternRegistry *registry_create(void) {
+    PatternRegistry *reg = malloc(sizeof(PatternRegistry));
+    const PatternInfo *info;
+    int n, i;
+    if (!reg) return NULL;
+    reg->cap = INITIAL_SLOTS;
+    reg->count = 0;
+    reg->slots = calloc((size_t)reg->cap, sizeof(PatternEntry));
+    if (!reg->slots) {
+        free(reg);
+        return NULL;
+    }
+    info = pattern_builtins(&n);
+    for (i = 0; i < n; i++) {
+        PatternEntry e;
+        memset(&e, 0, sizeof(e));
+        e.name = dup_string(info[i].name);
+        e.builtin = 1;
+        e.type = info[i].type;
+        e.width = info[i].width;
+        e.height = info[i].height;
+        if (!e.name || !insert(reg, &e)) {
+            registry_destroy(reg);
+            return NULL;
+        }
+    }
+    return reg;
+}
+
+void registry_destroy(PatternRegistry *reg) {
+    int i;
+    if (!reg) return;
+    for (i = 0; i < reg->cap; i++) {
+        free(reg->slots[i].name);
+        free(reg->slots[i].path);
+    }
+    free(reg->slots);
+    free(reg);
+}
+
+const PatternEntry *registry_find(const PatternRegistry *reg, const char *name) {
+    const PatternEntry *e = find_slot(reg->slots, reg->cap, name);
+    return e->name ? e : NULL;
+}
+
+int registry_count(const PatternRegistry *reg) {
+    return reg->count;
+}
+
+/*
+ * mtime_ns — Fecha de modificacion de st en nanosegundos.
+ */
+static long long mtime_ns(const struct stat *st) {
+#ifdef __APPLE__
+    return (long long)st->st_mtimespec.tv_sec * 1000000000LL + st->st_mtimespec.tv_nsec;
+#else
+    return (long long)st->st_mtim.tv_sec * 1000000000LL + st->st_mtim.tv_nsec;
+#endif
+}
+
+/*
+ * join_path — "dir/file" en memoria propia.
+ */
+static char *join_path(const char *dir, const char *file) {
+    size_t n = strlen(dir) + strlen(file) + 2;
+    char *p = malloc(n);
+    if (p) snprintf(p, n, "%s/%s", dir, file);
+    return p;
+}
+
+/*
+ * add_file_entry — Construye y registra la entrada de un archivo. El
+ * nombre es el del archivo sin extension; size y mtime son los que tenia
+ * el archivo al medirlo.
+ */
+static int add_file_entry(PatternRegistry *reg, const char *dir, const char *file,
+                          PatternFormat fmt, long offset, int64_t w, int64_t h,
+                          long long size, long long mtime) {
+    PatternEntry e;
+    const char *dot = strrchr(file, '.');
+    size_t len = dot ? (size_t)(dot - file) : strlen(file);
+    memset(&e, 0, sizeof(e));
+    e.name = malloc(len + 1);
+    e.path = join_path(dir, file);
+    if (!e.name || !e.path) {
+        free(e.name);
+        free(e.path);
+        return 0;
+    }
+    memcpy(e.name, file, len);
+    e.name[len] = '\0';
+    e.format = fmt;
+    e.offset = offset;
+    e.width = w;
+    e.height = h;
+    e.size = size;
+    e.mtime = mtime;
+    return insert(reg, &e);
+}
+
+/*
+ * dir_mtime — Fecha de modificacion del directorio en nanosegundos, o -1
+ * si falla stat.
+ */
+static long long dir_mtime(const char *dir) {
+    struct stat st;
+    if (stat(dir, &st) != 0) return -1;
+    return mtime_ns(&st);
+}
+
+/*
+ * measure_file — Mide un archivo de la biblioteca con pattern_measure y
+ * lo registra con el tamanio y mtime que tenia antes de abrirlo (si
+ * cambia mientras se mide, el proximo registry_load lo detecta).
+ * Retorna 1 si quedo registrado.
+ */
+static int measure_file(PatternRegistry *reg, const char *dir, const char *file,
+                        PatternFormat fmt) {
+    char *path = join_path(dir, file);
+    struct stat st;
+    FILE *f = path && stat(path, &st) == 0 ? fopen(path, "rb") : NULL;
+    long offset;
+    int64_t w, h;
+    int ok;
+    free(path);
+    if (!f) return 0;
+    ok = pattern_measure(f, fmt, &offset, &w, &h) &&
+         add_file_entry(reg, dir, file, fmt, offset, w, h, (long long)st.st_size,
+                        mtime_ns(&st));
+    fclose(f);
+    return ok;
+}
+
+/*
+ * file_in_dir — Nombre de archivo de path si esta directamente dentro de
+ * dir (no en un subdirectorio), o NULL.
+ */
+static const char *file_in_dir(const char *path, const char *dir) {
+    size_t n = strlen(dir);
+    if (strncmp(path, dir, n) != 0 || path[n] != '/' || strchr(path + n + 1, '/')) return NULL;
+    return path + n + 1;
+}
+
+/*
+ * write_index — Escribe el indice con las entradas registradas de los
+ * archivos de dir (primero a un temporal, luego rename atomico) y lo
+ * sella con el mtime que quedo en el directorio. Se llama justo despues
+ * de registrar dir, asi sus entradas son las vigentes. Si el indice no
+ * puede escribirse, las entradas quedan registradas igual.
+ */
+static void write_index(const PatternRegistry *reg, const char *dir) {
+    char *idx_path = join_path(dir, REGISTRY_INDEX_FILE);
+    char *tmp_path = join_path(dir, REGISTRY_INDEX_FILE ".tmp");
+    FILE *out = idx_path && tmp_path ? fopen(tmp_path, "w") : NULL;
+    int i, ok;
+    if (out) {
+        fprintf(out, "dosdoseis-index %d %020lld\n", INDEX_VERSION, 0LL);
+        for (i = 0; i < reg->cap; i++) {
+            const PatternEntry *e = &reg->slots[i];
+            const char *file;
+            if (!e->name || e->builtin || !(file = file_in_dir(e->path, dir))) continue;
+            fprintf(out, "%c %lld %lld %ld %lld %lld %s\n",
+                    e->format == PATTERN_FMT_MC ? 'm' : 'c', e->size, e->mtime,
+                    e->offset, (long long)e->width, (long long)e->height, file);
+        }
+        ok = fclose(out) == 0 && rename(tmp_path, idx_path) == 0;
+        if (ok && (out = fopen(idx_path, "r+")) != NULL) {
+            fprintf(out, "dosdoseis-index %d %020lld\n", INDEX_VERSION, dir_mtime(dir));
+            fclose(out);
+        } else if (!ok) {
+            remove(tmp_path);
+        }
+    }
+    free(idx_path);
+    free(tmp_path);
+}
+
+/*
+ * load_index — Registra las entradas del indice si su cabecera coincide
+ * con la version y el mtime actual del directorio. Las entradas se
+ * registran tal cual, sin stat: registry_load verifica la elegida.
+ * Retorna la cantidad de entradas, o -1 si el indice falta o esta viejo.
+ */
+static int load_index(PatternRegistry *reg, const char *dir, long long mtime) {
+    char line[INDEX_LINE_MAX];
+    char *path = join_path(dir, REGISTRY_INDEX_FILE);
+    FILE *f = path ? fopen(path, "r") : NULL;
+    int version, n = 0;
+    long long stamp;
+    free(path);
+    if (!f) return -1;
+    if (fscanf(f, "dosdoseis-index %d %lld\n", &version, &stamp) != 2 ||
+        version != INDEX_VERSION || stamp != mtime) {
+        fclose(f);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), f)) {
+        char kind;
+        const char *file;
+        PatternFormat fmt;
+        long offset;
+        long long size, fmtime, w, h;
+        int consumed = 0;
+        size_t len;
+        if (sscanf(line, "%c %lld %lld %ld %lld %lld %n", &kind, &size, &fmtime, &offset,
+                   &w, &h, &consumed) < 6 || consumed == 0)
+            continue;
+        len = strlen(line + consumed);
+        if (len > 0 && line[consumed + len - 1] == '\n') line[consumed + len - 1] = '\0';
+        file = line + consumed;
+        fmt = kind == 'm' ? PATTERN_FMT_MC : PATTERN_FMT_CELLS;
+        if (add_file_entry(reg, dir, file, fmt, offset, w, h, size, fmtime)) n++;
+    }
+    fclose(f);
+    return n;
+}
+
+/*
+ * rebuild_index — Mide cada archivo de la biblioteca, lo registra y
+ * escribe el indice nuevo.
+ */
+static int rebuild_index(PatternRegistry *reg, const char *dir) {
+    DIR *d = opendir(dir);
+    struct dirent *de;
+    int n = 0;
+    if (!d) return -1;
+    while ((de = readdir(d)) != NULL) {
+        PatternFormat fmt = pattern_format_from_path(de->d_name);
+        if (fmt == PATTERN_FMT_UNKNOWN || de->d_name[0] == '.') continue;
+        if (measure_file(reg, dir, de->d_name, fmt)) n++;
+    }
+    closedir(d);
+    write_index(reg, dir);
+    return n;
+}
+
+/*
+ * registry_add_dir — Usa el indice vigente o lo reconstruye.
+ */
+int registry_add_dir(PatternRegistry *reg, const char *dir) {
+    long long mtime = dir_mtime(dir);
+    int n;
+    if (mtime < 0) return -1;
+    n = load_index(reg, dir, mtime);
+    if (n < 0) return rebuild_index(reg, dir);
+    return n;
+}
+
+/*
+ * refresh_entry — Vuelve a medir la entrada de un archivo que cambio
+ * desde que se indexo (f abierto sobre el, st su stat) y reescribe el
+ * indice de su directorio. Corre (x, y) para conservar el centro que el
+ * llamador calculo con el bounding box viejo.
+ * Retorna 0 si el archivo ya no es un patron valido.
+ */
+static int refresh_entry(PatternRegistry *reg, PatternEntry *e, FILE *f,
+                         const struct stat *st, int64_t *x, int64_t *y) {
+    long offset;
+    int64_t w, h;
+    char *dir;
+    const char *slash = strrchr(e->path, '/');
+    if (!pattern_measure(f, e->format, &offset, &w, &h)) return 0;
+    *x += (e->width - w) / 2;
+    *y += (e->height - h) / 2;
+    e->offset = offset;
+    e->width = w;
+    e->height = h;
+    e->size = (long long)st->st_size;
+    e->mtime = mtime_ns(st);
+    dir = slash ? malloc((size_t)(slash - e->path) + 1) : NULL;
+    if (dir) {
+        memcpy(dir, e->path, (size_t)(slash - e->path));
+        dir[slash - e->path] = '\0';
+        write_index(reg, dir);
+        free(dir);
+    }
+    return 1;
+}
+
+/*
+ * registry_load — Predefinidos via pattern_load; archivos con fseek al
+ * offset indexado. Antes se compara el tamanio y el mtime del archivo
+ * con los indexados, asi el stat es uno solo por arranque. Para .mc el
+ * origen del quadtree esta en el centro del bounding box indexado.
+ */
+int registry_load(PatternRegistry *reg, const PatternEntry *e, Game *g, int64_t x, int64_t y) {
+    PatternEntry *slot;
+    struct stat st;
+    FILE *f;
+    int ok;
+    if (e->builtin) {
+        if (x > INT_MAX || y > INT_MAX || x < -INT_MAX || y < -INT_MAX) return 1;
+        pattern_load(g, e->type, (int)x, (int)y);
+        return 1;
+    }
+    f = fopen(e->path, "rb");
+    if (!f) return 0;
+    slot = find_slot(reg->slots, reg->cap, e->name);
+    if (fstat(fileno(f), &st) == 0 &&
+        ((long long)st.st_size != e->size || mtime_ns(&st) != e->mtime) &&
+        !refresh_entry(reg, slot, f, &st, &x, &y)) {
+        fclose(f);
+        return 0;
+    }
+    if (fseek(f, e->offset, SEEK_SET) != 0) {
+        fclose(f);
+        return 0;
+    }
+    if (e->format == PATTERN_FMT_MC)
+        ok = pattern_read_stream(f, e->format, g, x + e->width / 2, y + e->height / 2);
+    else
+        ok = pattern_read_stream(f, e->format, g, x, y);
+    fclose(f);
+    return ok;
+}
@@ -0,0 +1,106 @@
+/*
+ * registry.h — Registro unificado de patrones por nombre.
+ *
+ * Resuelve el argumento de --pattern en O(1) mediante una tabla hash que
+ * contiene tanto los patrones predefinidos de patterns.c como los archivos
+ * de una biblioteca en disco (--pattern-dir).
+ *
+ * Para bibliotecas de decenas de miles de archivos, el registro no parsea
+ * cada patron al arrancar: mantiene un indice en disco (INDEX_FILE dentro
+ * del directorio) con nombre, formato, offset de datos y bounding box de
+ * cada archivo. El indice se reconstruye solo si la fecha de modificacion
+ * del directorio cambio (se agregaron, borraron o renombraron archivos).
+ * Los archivos se abren recien al cargar el patron elegido, con un fseek
+ * directo al offset indexado; un archivo editado en su lugar se detecta
+ * ahi por su tamanio y su fecha, y solo esa entrada se vuelve a medir.
+ */
+
+#ifndef REGISTRY_H
+#define REGISTRY_H
+
+#include <stdint.h>     /* int64_t */
+#include "game.h"
+#include "patterns.h"
+#include "pattern_io.h"
+
+/* Nombre del archivo de indice dentro del directorio de la biblioteca */
+#define REGISTRY_INDEX_FILE ".patterns.idx"
+
+/*
+ * PatternEntry — Un patron registrado.
+ *
+ * name    — Clave de busqueda: nombre del predefinido o nombre del
+ *           archivo sin extension.
+ * builtin — 1 si es un patron de patterns.c (usar type), 0 si es archivo.
+ * type    — PatternType del predefinido (solo si builtin).
+ * path    — Ruta completa del archivo (solo si !builtin).
+ * format  — Formato del archivo.
+ * offset  — Byte donde empiezan los datos del archivo.
+ * width, height — Bounding box (ver pattern_measure).
+ * size, mtime — Tamanio y fecha de modificacion (en nanosegundos) del
+ *           archivo cuando se midio (solo si !builtin); registry_load
+ *           los usa para detectar ediciones.
+ */
+typedef struct {
+    char *name;
+    int builtin;
+    PatternType type;
+    char *path;
+    PatternFormat format;
+    long offset;
+    int64_t width;
+    int64_t height;
+    long long size;
+    long long mtime;
+} PatternEntry;
+
+typedef struct PatternRegistry PatternRegistry;
+
+/*
+ * registry_create — Crea el registro con los patrones predefinidos ya
+ * registrados. Retorna NULL si falla la alocacion.
+ */
+PatternRegistry *registry_create(void);
+
+/*
+ * registry_destroy — Libera el registro y todas sus entradas. Acepta NULL.
+ */
+void registry_destroy(PatternRegistry *reg);
+
+/*
+ * registry_add_dir — Registra todos los .cells y .mc del directorio.
+ *
+ * Usa el indice en disco si esta vigente, sin abrir ni hacer stat de
+ * cada archivo; si no, mide cada archivo con pattern_measure y reescribe
+ * el indice (si el directorio no admite escritura, el registro funciona
+ * igual sin cachear). Un archivo cuyo
+ * nombre coincide con un predefinido lo reemplaza.
+ * Retorna la cantidad de patrones registrados, o -1 si el directorio
+ * no puede abrirse.
+ */
+int registry_add_dir(PatternRegistry *reg, const char *dir);
+
+/*
+ * registry_find — Busca un patron por nombre. Retorna NULL si no existe.
+ */
+const PatternEntry *registry_find(const PatternRegistry *reg, const char *name);
+
+/*
+ * registry_count — Cantidad de patrones registrados.
+ */
+int registry_count(const PatternRegistry *reg);
+
+/*
+ * registry_load — Coloca el patron e (obtenido con registry_find sobre
+ * reg) en el Game con la esquina superior izquierda de su bounding box en
+ * (x, y). Las coordenadas son de 64 bits porque el bounding box de un .mc
+ * puede ser mucho mayor que el grid (x, y negativos y enormes).
+ *
+ * Si el archivo cambio desde que se indexo, la entrada se vuelve a medir
+ * (e queda actualizada), el indice se reescribe y el patron se corre
+ * para conservar el centro del bounding box viejo.
+ * Retorna 1 en exito, 0 si el archivo no puede leerse.
+ */
+int registry_load(PatternRegistry *reg, const PatternEntry *e, Game *g, int64_t x, int64_t y);
+
+#endif
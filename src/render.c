@@ -5,34 +5,145 @@
  * El pipeline de rendering por frame es:
  *   1. Limpiar el backbuffer con el color de fondo.
  *   2. Dibujar las celdas vivas como rectangulos solidos.
- *   3. Dibujar las lineas del grid (si cell_size >= 4px).
+ *   3. Componer las lineas del grid (si cell_size >= 4px).
  *   4. Presentar el backbuffer (SDL_RenderPresent).
  *
+ * Las lineas del grid no cambian entre frames, asi que se dibujan una
+ * sola vez en una textura target (grid_tex) y cada frame se componen con
+ * un unico SDL_RenderCopy en lugar de width + height + 2 llamadas a
+ * SDL_RenderDrawLine. La textura se regenera al cambiar el zoom o el
+ * tamanio de la ventana.
+ *
  * El renderer usa aceleracion por hardware (SDL_RENDERER_ACCELERATED),
  * delegando las operaciones de dibujo a la GPU cuando esta disponible.
  */
 
 #include <stdio.h>   /* snprintf */
 #include "render.h"
+#include "trace.h"
+
+/* Color de las lineas del grid: gris medio sutil */
+#define GRID_LINE_R 40
+#define GRID_LINE_G 40
+#define GRID_LINE_B 40
+
+/*
+ * draw_grid_lines — Traza las lineas verticales y horizontales del grid
+ * sobre el target actual del renderer (la ventana o grid_tex).
+ */
+static void draw_grid_lines(Renderer *r) {
+    int x, y;
+    int cs = r->cell_size;
+    SDL_SetRenderDrawColor(r->renderer, GRID_LINE_R, GRID_LINE_G, GRID_LINE_B, 255);
+    for (x = 0; x <= r->grid_w; x++) {
+        SDL_RenderDrawLine(r->renderer, x * cs, 0, x * cs, r->grid_h * cs);
+    }
+    for (y = 0; y <= r->grid_h; y++) {
+        SDL_RenderDrawLine(r->renderer, 0, y * cs, r->grid_w * cs, y * cs);
+    }
+}
+
+/*
+ * build_palette — Precalcula la paleta del heatmap.
+ *
+ * Interpola linealmente entre cuatro colores de referencia repartidos
+ * uniformemente en [0, 255]: azul oscuro, cian, amarillo y rojo.
+ * Con la tabla precalculada, colorear una celda es un solo acceso
+ * indexado por su valor heat, sin aritmetica de color por frame.
+ */
+static void build_palette(Renderer *r) {
+    static const SDL_Color stops[4] = {
+        { 30, 30, 120, 255 },   /* heat bajo: azul oscuro */
+        { 0, 180, 180, 255 },   /* cian */
+        { 230, 220, 0, 255 },   /* amarillo */
+        { 255, 60, 0, 255 }     /* heat alto: rojo anaranjado */
+    };
+    int i;
+    for (i = 0; i < 256; i++) {
+        int pos = i * 3;               /* posicion en [0, 765] */
+        int seg = pos / 255;           /* tramo entre stops: 0, 1 o 2 */
+        if (seg > 2) seg = 2;
+        int t = pos - seg * 255;       /* avance dentro del tramo [0, 255] */
+        const SDL_Color *a = &stops[seg];
+        const SDL_Color *b = &stops[seg + 1];
+        r->palette[i].r = (Uint8)(a->r + (b->r - a->r) * t / 255);
+        r->palette[i].g = (Uint8)(a->g + (b->g - a->g) * t / 255);
+        r->palette[i].b = (Uint8)(a->b + (b->b - a->b) * t / 255);
+        r->palette[i].a = 255;
+    }
+}
+
+/*
+ * renderer_rebuild_grid — (Re)crea la textura overlay con las lineas.
+ *
+ * 1. Destruye la textura anterior, si existe.
+ * 2. Con celdas < 4px no hay lineas: grid_tex queda en NULL.
+ * 3. Crea una textura RGBA con acceso TARGET del tamanio de la ventana
+ *    y blending activado, para que el fondo transparente deje ver las
+ *    celdas al componerla.
+ * 4. Redirige el renderer a la textura, la limpia a alfa 0, traza las
+ *    lineas y restaura el target por defecto (la ventana).
+ *
+ * Si el driver no soporta render targets, grid_tex queda en NULL y
+ * renderer_draw cae al trazado directo de lineas.
+ */
+void renderer_rebuild_grid(Renderer *r) {
+    if (r->grid_tex) {
+        SDL_DestroyTexture(r->grid_tex);
+        r->grid_tex = NULL;
+    }
+    if (r->cell_size < 4) return;
+
+    int tex_w = r->grid_w * r->cell_size;
+    int tex_h = r->grid_h * r->cell_size;
+    r->grid_tex = SDL_CreateTexture(r->renderer, SDL_PIXELFORMAT_RGBA8888,
+                                    SDL_TEXTUREACCESS_TARGET, tex_w, tex_h);
+    if (!r->grid_tex) return;
+    SDL_SetTextureBlendMode(r->grid_tex, SDL_BLENDMODE_BLEND);
+
+    if (SDL_SetRenderTarget(r->renderer, r->grid_tex) != 0) {
+        SDL_DestroyTexture(r->grid_tex);
+        r->grid_tex = NULL;
+        return;
+    }
+    SDL_SetRenderDrawColor(r->renderer, 0, 0, 0, 0);
+    SDL_RenderClear(r->renderer);
+    draw_grid_lines(r);
+    SDL_SetRenderTarget(r->renderer, NULL);
+}
 
 /*
  * renderer_create — Inicializa la ventana y el renderer SDL2.
  *
- * 1. Aloca la estructura Renderer con malloc.
+ * 1. Aloca la estructura Renderer y el buffer de fila con malloc.
  * 2. Almacena las dimensiones del grid y el tamanio de celda.
  * 3. Calcula el tamanio de la ventana en pixeles (grid * cell_size).
  * 4. Crea la ventana SDL2 centrada en la pantalla con SDL_WINDOW_SHOWN
  *    para que sea visible inmediatamente.
- * 5. Crea el renderer con SDL_RENDERER_ACCELERATED para usar GPU.
+ * 5. Crea el renderer con SDL_RENDERER_ACCELERATED para usar GPU y
+ *    SDL_RENDERER_TARGETTEXTURE para poder dibujar en texturas. Si el
+ *    driver no soporta render targets se reintenta sin esa flag: la
+ *    textura de lineas no se crea y se trazan directamente.
+ *    Si se pidio vsync se agrega SDL_RENDERER_PRESENTVSYNC, y luego se
+ *    consulta SDL_GetRendererInfo porque el driver puede ignorarlo.
  *    El indice -1 indica que SDL elija el primer driver disponible.
- * 6. Si cualquier paso falla, limpia los recursos previos y retorna NULL.
+ * 6. Consulta la frecuencia de refresco del display de la ventana.
+ * 7. Pre-renderiza la textura de lineas del grid.
+ * 8. Si cualquier paso falla, limpia los recursos previos y retorna NULL.
  */
-Renderer *renderer_create(int grid_w, int grid_h, int cell_size) {
+Renderer *renderer_create(int grid_w, int grid_h, int cell_size, int vsync) {
     Renderer *r = malloc(sizeof(Renderer));
     if (!r) return NULL;
     r->cell_size = cell_size;
     r->grid_w = grid_w;
     r->grid_h = grid_h;
+    r->grid_tex = NULL;
+    r->row = malloc((size_t)grid_w);
+    if (!r->row) {
+        free(r);
+        return NULL;
+    }
+    build_palette(r);
     int win_w = grid_w * cell_size;
     int win_h = grid_h * cell_size;
     r->window = SDL_CreateWindow(
@@ -41,29 +152,61 @@ Renderer *renderer_create(int grid_w, int grid_h, int cell_size) {
         win_w, win_h, SDL_WINDOW_SHOWN
     );
     if (!r->window) {
+        free(r->row);
         free(r);
         return NULL;
     }
-    r->renderer = SDL_CreateRenderer(r->window, -1, SDL_RENDERER_ACCELERATED);
+    Uint32 flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
+    if (vsync) flags |= SDL_RENDERER_PRESENTVSYNC;
+    r->renderer = SDL_CreateRenderer(r->window, -1, flags);
+    if (!r->renderer)
+        r->renderer = SDL_CreateRenderer(r->window, -1, flags & ~(Uint32)SDL_RENDERER_TARGETTEXTURE);
     if (!r->renderer) {
         SDL_DestroyWindow(r->window);
+        free(r->row);
         free(r);
         return NULL;
     }
+    SDL_RendererInfo info;
+    r->vsync = SDL_GetRendererInfo(r->renderer, &info) == 0 &&
+               (info.flags & SDL_RENDERER_PRESENTVSYNC) != 0;
+    SDL_DisplayMode mode;
+    r->refresh_hz = 60;
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(r->window), &mode) == 0 &&
+        mode.refresh_rate > 0)
+        r->refresh_hz = mode.refresh_rate;
+    renderer_rebuild_grid(r);
     return r;
 }
 
+/*
+ * renderer_set_cell_size — Aplica un nuevo zoom.
+ *
+ * Ajusta el tamanio de la ventana a las nuevas dimensiones en pixeles y
+ * regenera la textura de lineas, cuyo tamanio y espaciado dependen
+ * de cell_size. Valores menores a 1 se ignoran.
+ */
+void renderer_set_cell_size(Renderer *r, int cell_size) {
+    if (cell_size < 1 || cell_size == r->cell_size) return;
+    r->cell_size = cell_size;
+    SDL_SetWindowSize(r->window, r->grid_w * cell_size, r->grid_h * cell_size);
+    renderer_rebuild_grid(r);
+}
+
 /*
  * renderer_destroy — Libera todos los recursos SDL2 y la estructura.
  *
- * El orden de destruccion importa: primero el renderer (que depende
- * de la ventana), luego la ventana, y finalmente la estructura.
+ * El orden de destruccion importa: primero la textura del grid (que
+ * pertenece al renderer), luego el renderer (que depende de la ventana),
+ * luego la ventana, y finalmente la estructura.
  * Las verificaciones de NULL previenen crashes con punteros invalidos.
  */
 void renderer_destroy(Renderer *r) {
     if (!r) return;
+    if (r->grid_tex) SDL_DestroyTexture(r->grid_tex);
     if (r->renderer) SDL_DestroyRenderer(r->renderer);
     if (r->window) SDL_DestroyWindow(r->window);
+    free(r->row);
     free(r);
 }
 
@@ -77,19 +220,27 @@ void renderer_destroy(Renderer *r) {
  *
  * Paso 2: Dibujar celdas vivas.
  *   Se cambia el color a verde (R=0, G=200, B=0) y se itera sobre
- *   todo el grid. Para cada celda viva, se crea un SDL_Rect con:
+ *   todo el grid, leyendo cada fila a r->row con game_read_region (un
+ *   memcpy o una conversion por fila, sin verificar limites por celda).
+ *   Para cada celda viva, se crea un SDL_Rect con:
  *     - Posicion: (x * cell_size, y * cell_size)
  *     - Tamanio: (cell_size - 1, cell_size - 1)
  *   El -1 en el tamanio deja un pixel de separacion entre celdas,
  *   creando un efecto visual de grid sin lineas explicitas.
  *   SDL_RenderFillRect dibuja el rectangulo solido.
  *
+ *   Con tracking activo (g->heat != NULL) el color sale de la paleta
+ *   indexada por el valor heat. En modo edad solo se dibujan las celdas
+ *   vivas; en modo actividad tambien las muertas con actividad reciente,
+ *   lo que deja un rastro visible de donde hubo cambios.
+ *
  * Paso 3: Lineas del grid (condicional).
  *   Solo se dibujan si cell_size >= 4 pixeles, ya que en tamanios
  *   menores las lineas saturarian visualmente la imagen.
- *   Se usa gris medio (R=40, G=40, B=40) para lineas sutiles.
- *   SDL_RenderDrawLine traza lineas verticales y horizontales
- *   que delimitan cada celda del grid.
+ *   Las lineas ya estan pre-renderizadas en grid_tex, de modo que se
+ *   componen con un unico SDL_RenderCopy. En un grid de 400x300 esto
+ *   sustituye 702 llamadas a SDL_RenderDrawLine por frame. Si la textura
+ *   no pudo crearse, se trazan directamente como fallback.
  *
  * Paso 4: Presentar.
  *   SDL_RenderPresent intercambia el backbuffer con el frontbuffer,
@@ -104,30 +255,61 @@ void renderer_draw(Renderer *r, Game *g) {
     SDL_SetRenderDrawColor(r->renderer, 20, 20, 20, 255);
     SDL_RenderClear(r->renderer);
 
-    /* Paso 2: celdas vivas en verde */
-    SDL_SetRenderDrawColor(r->renderer, 0, 200, 0, 255);
-    for (y = 0; y < g->height; y++) {
-        for (x = 0; x < g->width; x++) {
-            if (game_get_cell(g, x, y)) {
+    if (g->heat) {
+        /* Paso 2 (heatmap): color por celda desde la paleta */
+        for (y = 0; y < g->height; y++) {
+            const unsigned char *hrow = g->heat + (size_t)y * g->width;
+            game_read_region(g, 0, y, r->grid_w, 1, r->row, (size_t)r->grid_w);
+            for (x = 0; x < r->grid_w; x++) {
+                int alive = r->row[x];
+                if (!alive && (g->track == GAME_TRACK_AGE || hrow[x] == 0))
+                    continue;
+                const SDL_Color *c = &r->palette[hrow[x]];
+                SDL_SetRenderDrawColor(r->renderer, c->r, c->g, c->b, 255);
                 SDL_Rect rect = { x * cs, y * cs, cs - 1, cs - 1 };
                 SDL_RenderFillRect(r->renderer, &rect);
             }
         }
+    } else {
+        /* Paso 2: celdas vivas en verde */
+        SDL_SetRenderDrawColor(r->renderer, 0, 200, 0, 255);
+        for (y = 0; y < g->height; y++) {
+            game_read_region(g, 0, y, r->grid_w, 1, r->row, (size_t)r->grid_w);
+            for (x = 0; x < r->grid_w; x++) {
+                if (r->row[x]) {
+                    SDL_Rect rect = { x * cs, y * cs, cs - 1, cs - 1 };
+                    SDL_RenderFillRect(r->renderer, &rect);
+                }
+            }
+        }
     }
 
     /* Paso 3: lineas del grid, solo si las celdas son >= 4px */
     if (cs >= 4) {
-        SDL_SetRenderDrawColor(r->renderer, 40, 40, 40, 255);
-        for (x = 0; x <= g->width; x++) {
-            SDL_RenderDrawLine(r->renderer, x * cs, 0, x * cs, g->height * cs);
-        }
-        for (y = 0; y <= g->height; y++) {
-            SDL_RenderDrawLine(r->renderer, 0, y * cs, g->width * cs, y * cs);
+        if (r->grid_tex) {
+            SDL_RenderCopy(r->renderer, r->grid_tex, NULL, NULL);
+        } else {
+            draw_grid_lines(r);
         }
     }
 
-    /* Paso 4: presentar el frame */
-    SDL_RenderPresent(r->renderer);
+    /* Paso 4: presentar el frame (con vsync, espera el retrazado) */
+    {
+        TRACE_BEGIN(t);
+        SDL_RenderPresent(r->renderer);
+        TRACE_END(TRACE_PRESENT, 0, t);
+    }
+}
+
+/*
+ * renderer_cell_at — Las celdas se dibujan desde el origen de la ventana
+ * a cell_size pixeles cada una, asi que la celda es el cociente.
+ */
+int renderer_cell_at(const Renderer *r, int px, int py, int *x, int *y) {
+    if (px < 0 || py < 0) return 0;
+    *x = px / r->cell_size;
+    *y = py / r->cell_size;
+    return *x < r->grid_w && *y < r->grid_h;
 }
 
 /*
@@ -135,18 +317,52 @@ void renderer_draw(Renderer *r, Game *g) {
  *
  * Construye un string con snprintf que incluye:
  *   - Numero de generacion actual.
- *   - FPS target configurado.
+ *   - Poblacion y tamanio del bounding box de las celdas vivas. Ambos
+ *     salen de game_stats, que game_step ya calculo: no recorren el grid.
+ *   - Velocidad configurada en generaciones por segundo.
  *   - Indicador "PAUSED" si la simulacion esta pausada.
  *
  * Se usa el titulo de la ventana (SDL_SetWindowTitle) como HUD ligero
  * para evitar la dependencia adicional de SDL2_ttf, que requeriria
  * cargar fuentes y gestionar texturas de texto.
  *
- * El buffer de 128 bytes es mas que suficiente para el formato usado.
+ * El buffer de 192 bytes es mas que suficiente para el formato usado.
+ */
+void renderer_draw_hud(Renderer *r, long generation, const GameStats *stats,
+                       int paused, int gens_per_sec) {
+    char title[192];
+    int box_w = stats->population ? stats->max_x - stats->min_x + 1 : 0;
+    int box_h = stats->population ? stats->max_y - stats->min_y + 1 : 0;
+    snprintf(title, sizeof(title),
+             "Game of Life | Gen: %ld | Pop: %llu | Box: %dx%d | Speed: %d gen/s%s",
+             generation, (unsigned long long)stats->population, box_w, box_h,
+             gens_per_sec, paused ? " | PAUSED" : "");
+    SDL_SetWindowTitle(r->window, title);
+}
+
+/*
+ * renderer_draw_goto_prompt — El cursor "_" marca que se esperan digitos.
+ */
+void renderer_draw_goto_prompt(Renderer *r, long value) {
+    char title[192];
+    char digits[24] = "";
+    if (value >= 0) snprintf(digits, sizeof(digits), "%ld", value);
+    snprintf(title, sizeof(title),
+             "Game of Life | Go to generation: %s_ | Enter to jump, Esc to cancel", digits);
+    SDL_SetWindowTitle(r->window, title);
+}
+
+/*
+ * renderer_draw_goto_progress — Reemplaza al HUD mientras dura el salto;
+ * el grid no se redibuja hasta llegar.
  */
-void renderer_draw_hud(Renderer *r, int generation, int paused, int fps) {
-    char title[128];
-    snprintf(title, sizeof(title), "Game of Life | Gen: %d | FPS: %d%s",
-             generation, fps, paused ? " | PAUSED" : "");
+void renderer_draw_goto_progress(Renderer *r, long generation, long start, long target,
+                                 double gens_per_sec) {
+    char title[192];
+    double done = target > start ? 100.0 * (double)(generation - start) / (double)(target - start)
+                                 : 100.0;
+    snprintf(title, sizeof(title),
+             "Game of Life | Jumping to %ld: %.1f%% | Gen: %ld | %.0f gen/s | Esc to cancel",
+             target, done, generation, gens_per_sec);
     SDL_SetWindowTitle(r->window, title);
 }
@@ -8,7 +8,10 @@
  * El modulo maneja:
  *   - Creacion y destruccion de la ventana SDL2.
  *   - Dibujado del grid con celdas vivas coloreadas.
- *   - Lineas de grid sutiles para celdas grandes (>= 4px).
+ *   - Lineas de grid sutiles para celdas grandes (>= 4px), pre-renderizadas
+ *     una sola vez en una textura overlay.
+ *   - Modo heatmap: colorea las celdas segun el buffer heat del Game
+ *     (edad o actividad) mediante una paleta precalculada de 256 colores.
  *   - HUD informativo en el titulo de la ventana.
  */
 
@@ -26,6 +29,17 @@
  * cell_size — Tamanio en pixeles de cada celda del grid.
  * grid_w    — Ancho del grid en celdas (para calculos de ventana).
  * grid_h    — Alto del grid en celdas.
+ * grid_tex  — Textura con las lineas del grid ya dibujadas sobre fondo
+ *             transparente. NULL si cell_size < 4 o si el driver no soporta
+ *             render targets (en ese caso se dibujan las lineas directamente).
+ * vsync     — 1 si el renderer presenta sincronizado con el refresco
+ *             (SDL_RenderPresent bloquea hasta el retrazado vertical).
+ * refresh_hz — Frecuencia de refresco del display de la ventana (60 si
+ *             SDL no la reporta).
+ * palette   — Tabla de 256 colores indexada por el valor heat de la celda
+ *             (azul = bajo, rojo = alto). Se calcula una vez en renderer_create.
+ * row       — Buffer de grid_w bytes donde renderer_draw lee cada fila del
+ *             grid con game_read_region.
  *
  * El tamanio de la ventana es grid_w * cell_size x grid_h * cell_size pixeles.
  */
@@ -35,15 +49,44 @@ typedef struct {
     int cell_size;
     int grid_w;
     int grid_h;
+    SDL_Texture *grid_tex;
+    int vsync;
+    int refresh_hz;
+    SDL_Color palette[256];
+    unsigned char *row;
 } Renderer;
 
 /*
  * renderer_create — Crea la ventana SDL2 y su renderer.
  * La ventana se centra en la pantalla y tiene tamanio grid_w * cell_size
  * por grid_h * cell_size pixeles. Usa renderer acelerado por hardware.
+ * Con vsync != 0 pide presentacion sincronizada con el refresco; el campo
+ * vsync refleja si el driver realmente la concedio.
+ * Pre-renderiza las lineas del grid en grid_tex.
  * Retorna NULL si la creacion de ventana o renderer falla.
  */
-Renderer *renderer_create(int grid_w, int grid_h, int cell_size);
+Renderer *renderer_create(int grid_w, int grid_h, int cell_size, int vsync);
+
+/*
+ * renderer_set_cell_size — Cambia el zoom (pixeles por celda).
+ * Redimensiona la ventana y regenera la textura de lineas del grid.
+ */
+void renderer_set_cell_size(Renderer *r, int cell_size);
+
+/*
+ * renderer_rebuild_grid — Regenera la textura de lineas del grid.
+ * Debe llamarse tras un cambio de tamanio de ventana o cuando SDL
+ * reporta SDL_RENDER_TARGETS_RESET (el contenido de las texturas
+ * target se pierde, por ejemplo al recrear el dispositivo grafico).
+ */
+void renderer_rebuild_grid(Renderer *r);
+
+/*
+ * renderer_cell_at — Celda del grid bajo el pixel (px, py) de la
+ * ventana, como las coordenadas de los eventos del mouse. Retorna 0 si
+ * el pixel cae fuera del grid.
+ */
+int renderer_cell_at(const Renderer *r, int px, int py, int *x, int *y);
 
 /*
  * renderer_destroy — Libera el renderer, la ventana y la estructura.
@@ -54,17 +97,36 @@ void renderer_destroy(Renderer *r);
 /*
  * renderer_draw — Dibuja el estado actual del Game en la ventana.
  * Limpia el fondo a gris oscuro (20, 20, 20), dibuja las celdas vivas
- * como rectangulos verdes, y opcionalmente las lineas del grid.
+ * como rectangulos verdes (o con el color de la paleta heatmap si el
+ * Game tiene tracking activo), y opcionalmente compone la textura de lineas
+ * del grid con un solo SDL_RenderCopy.
  * Llama a SDL_RenderPresent al final para mostrar el frame.
  */
 void renderer_draw(Renderer *r, Game *g);
 
 /*
  * renderer_draw_hud — Actualiza el titulo de la ventana con informacion.
- * Muestra la generacion actual, FPS target y estado de pausa.
+ * Muestra la generacion actual, la poblacion y el tamanio de su bounding
+ * box (de game_stats), la velocidad pedida en generaciones por segundo y
+ * el estado de pausa.
  * Se usa el titulo de ventana en lugar de texto renderizado para
  * evitar la dependencia de SDL2_ttf.
  */
-void renderer_draw_hud(Renderer *r, int generation, int paused, int fps);
+void renderer_draw_hud(Renderer *r, long generation, const GameStats *stats,
+                       int paused, int gens_per_sec);
+
+/*
+ * renderer_draw_goto_prompt — Titulo mientras se escribe el destino de
+ * la tecla G. value < 0 indica que todavia no se escribio ningun digito.
+ */
+void renderer_draw_goto_prompt(Renderer *r, long value);
+
+/*
+ * renderer_draw_goto_progress — Titulo durante un salto a la generacion
+ * target que empezo en start: porcentaje recorrido, generacion actual y
+ * ritmo medido en generaciones por segundo.
+ */
+void renderer_draw_goto_progress(Renderer *r, long generation, long start, long target,
+                                 double gens_per_sec);
 
 #endif
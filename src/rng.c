@@ -0,0 +1,85 @@
+/*
+ * rng.c — Implementacion del generador por contador.
+ *
+ * Densidad por combinacion de bits: para obtener bits con probabilidad
+ * p = t / 256, se recorren los bits de t desde el menos significativo.
+ * Partiendo de m = 0, por cada bit de t se toma una palabra aleatoria r
+ * uniforme y se hace m = m | r si el bit es 1, o m = m & r si es 0.
+ * Cada paso transforma la probabilidad q de cada bit de m en (1 + q) / 2
+ * o q / 2, asi que tras procesar los 8 bits queda exactamente t / 256.
+ * Los ceros menos significativos de t se saltan (con m = 0, m & r = 0),
+ * por lo que p = 0.5 necesita una sola palabra aleatoria para 64 celdas.
+ */
+
+#include <stdlib.h>  /* strtoull */
+#include <errno.h>   /* errno, ERANGE */
+#include <ctype.h>   /* isdigit, isxdigit */
+#include "rng.h"
+
+/* Incremento de la secuencia SplitMix64 (parte fraccionaria de phi) */
+#define GOLDEN_GAMMA 0x9E3779B97F4A7C15ull
+
+uint64_t rng_mix64(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/*
+ * rng_at — SplitMix64 avanza su estado sumando GOLDEN_GAMMA; el valor
+ * numero counter es por lo tanto mix64(seed + (counter + 1) * gamma).
+ */
+uint64_t rng_at(uint64_t seed, uint64_t counter) {
+    return rng_mix64(seed + (counter + 1) * GOLDEN_GAMMA);
+}
+
+unsigned rng_density_threshold(float density) {
+    const unsigned one = 1u << RNG_DENSITY_BITS;
+    if (!(density > 0.0f)) return 0;
+    if (density >= 1.0f) return one;
+    return (unsigned)(density * (float)one + 0.5f);
+}
+
+/*
+ * rng_bernoulli64 — Cada palabra usa los contadores
+ * [index * RNG_DENSITY_BITS, (index + 1) * RNG_DENSITY_BITS), de modo
+ * que palabras distintas nunca comparten valores aleatorios.
+ */
+uint64_t rng_bernoulli64(uint64_t seed, uint64_t index, unsigned threshold) {
+    uint64_t base = index * RNG_DENSITY_BITS;
+    uint64_t m = 0;
+    int j = 0;
+    if (threshold >= (1u << RNG_DENSITY_BITS)) return ~(uint64_t)0;
+    if (threshold == 0) return 0;
+    while (!((threshold >> j) & 1u)) j++;
+    for (; j < RNG_DENSITY_BITS; j++) {
+        uint64_t r = rng_at(seed, base + (uint64_t)j);
+        m = ((threshold >> j) & 1u) ? (m | r) : (m & r);
+    }
+    return m;
+}
+
+/*
+ * rng_parse_seed — Base 16 solo con prefijo 0x/0X y base 10 en otro
+ * caso: con base 0, strtoull leeria "010" como octal. El texto tiene que
+ * empezar con un digito de esa base, porque strtoull saltearia espacios
+ * iniciales y aceptaria un signo (negando el valor con '-'). Se
+ * rechazan tambien los caracteres sobrantes y el desborde.
+ */
+int rng_parse_seed(const char *text, uint64_t *out) {
+    const char *digits = text;
+    char *end;
+    unsigned long long v;
+    int base = 10;
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        digits = text + 2;
+        base = 16;
+    }
+    if (base == 16 ? !isxdigit((unsigned char)digits[0]) : !isdigit((unsigned char)digits[0]))
+        return 0;
+    errno = 0;
+    v = strtoull(digits, &end, base);
+    if (*end != '\0' || errno == ERANGE) return 0;
+    *out = (uint64_t)v;
+    return 1;
+}
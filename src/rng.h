@@ -0,0 +1,57 @@
+/*
+ * rng.h — Generador pseudoaleatorio propio del proyecto, basado en contador.
+ *
+ * En lugar de un estado secuencial (como rand()), cada valor es una funcion
+ * pura de (semilla, contador): rng_at(seed, i) es el i-esimo valor de la
+ * secuencia SplitMix64 de esa semilla. Esto permite:
+ *   - Generar cualquier tramo de la secuencia sin generar los anteriores,
+ *     por lo que varios threads pueden llenar partes distintas del grid.
+ *   - Resultados identicos sin importar cuantos threads se usen ni en que
+ *     orden terminen, ni la plataforma o la libc.
+ */
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>  /* uint64_t */
+
+/*
+ * Bits de precision de la densidad en rng_bernoulli64. La densidad se
+ * cuantiza a multiplos de 1/256 y cada palabra de 64 celdas consume como
+ * maximo RNG_DENSITY_BITS valores de 64 bits (solo uno para 0.5).
+ */
+#define RNG_DENSITY_BITS 8
+
+/*
+ * rng_mix64 — Finalizador de SplitMix64: biyeccion de 64 bits con buena
+ * difusion (cada bit de entrada afecta a todos los de salida).
+ */
+uint64_t rng_mix64(uint64_t x);
+
+/*
+ * rng_at — Valor numero counter de la secuencia de la semilla seed.
+ */
+uint64_t rng_at(uint64_t seed, uint64_t counter);
+
+/*
+ * rng_density_threshold — Cuantiza una densidad en [0, 1] al umbral
+ * entero en [0, 2^RNG_DENSITY_BITS] que espera rng_bernoulli64.
+ */
+unsigned rng_density_threshold(float density);
+
+/*
+ * rng_bernoulli64 — Palabra de 64 bits donde cada bit vale 1 con
+ * probabilidad threshold / 2^RNG_DENSITY_BITS, independiente de los demas.
+ * index identifica la palabra: el mismo (seed, index, threshold) produce
+ * siempre la misma palabra.
+ */
+uint64_t rng_bernoulli64(uint64_t seed, uint64_t index, unsigned threshold);
+
+/*
+ * rng_parse_seed — Lee una semilla de linea de comandos: entero sin signo
+ * de 64 bits en decimal o hexadecimal (prefijo 0x). Retorna 1 y escribe
+ * *out si el texto completo es valido; 0 si no.
+ */
+int rng_parse_seed(const char *text, uint64_t *out);
+
+#endif
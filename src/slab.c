@@ -0,0 +1,212 @@
+/*
+ * slab.c — Implementacion del pool de objetos de tamanio fijo.
+ *
+ * Cada objeto libre guarda en sus primeros bytes el puntero al siguiente
+ * de su lista (FreeObj). Las listas por worker van en estructuras de
+ * 64 bytes para que dos workers no compartan linea de cache.
+ *
+ * in_use y high_water se actualizan con operaciones atomicas (__atomic
+ * de GCC/clang): son los unicos contadores que todos los workers tocan.
+ */
+
+#include <stdlib.h>   /* malloc, calloc, free */
+#include <pthread.h>  /* pthread_mutex_t */
+#include "slab.h"
+
+/* Objetos que se mueven de una vez entre la lista global y un worker */
+#define SLAB_BATCH 32
+
+/* Largo de la lista de un worker a partir del cual devuelve un lote */
+#define SLAB_CACHE_MAX (2 * SLAB_BATCH)
+
+/* Alineacion de cada objeto dentro del slab */
+#define SLAB_ALIGN 16
+
+typedef struct FreeObj {
+    struct FreeObj *next;
+} FreeObj;
+
+/*
+ * Slab — Cabecera de un bloque; los objetos siguen a continuacion.
+ * El union fuerza la alineacion del primer objeto.
+ */
+typedef struct Slab {
+    struct Slab *prev;
+    union { long double ld; void *p; uint64_t u; } align;
+} Slab;
+
+/*
+ * WorkerCache — Lista libre de un worker y sus contadores.
+ */
+typedef struct {
+    FreeObj *head;
+    size_t count;
+    uint64_t hits;
+    uint64_t misses;
+    char pad[64 - sizeof(FreeObj *) - sizeof(size_t) - 2 * sizeof(uint64_t)];
+} WorkerCache;
+
+struct SlabPool {
+    size_t obj_size;
+    size_t objs_per_slab;
+    int nworkers;
+    WorkerCache *caches;
+    pthread_mutex_t mu;     /* Protege global y slabs */
+    FreeObj *global;
+    size_t global_count;
+    Slab *slabs;
+    uint64_t nslabs;
+    uint64_t in_use;        /* Atomico */
+    uint64_t high_water;    /* Atomico */
+};
+
+SlabPool *slab_create(size_t obj_size, size_t objs_per_slab, int nworkers) {
+    SlabPool *p = malloc(sizeof(SlabPool));
+    if (!p) return NULL;
+    if (obj_size < sizeof(FreeObj)) obj_size = sizeof(FreeObj);
+    if (nworkers < 1) nworkers = 1;
+    p->obj_size = (obj_size + SLAB_ALIGN - 1) & ~(size_t)(SLAB_ALIGN - 1);
+    p->objs_per_slab = objs_per_slab ? objs_per_slab : 1;
+    p->nworkers = nworkers;
+    p->caches = calloc((size_t)nworkers, sizeof(WorkerCache));
+    if (!p->caches) {
+        free(p);
+        return NULL;
+    }
+    pthread_mutex_init(&p->mu, NULL);
+    p->global = NULL;
+    p->global_count = 0;
+    p->slabs = NULL;
+    p->nslabs = 0;
+    p->in_use = 0;
+    p->high_water = 0;
+    return p;
+}
+
+void slab_destroy(SlabPool *p) {
+    if (!p) return;
+    while (p->slabs) {
+        Slab *s = p->slabs;
+        p->slabs = s->prev;
+        free(s);
+    }
+    pthread_mutex_destroy(&p->mu);
+    free(p->caches);
+    free(p);
+}
+
+/*
+ * refill — Llena la lista vacia de un worker: un lote de la lista
+ * global o, si esta vacia, un slab nuevo completo. Retorna 1 si la
+ * lista quedo con objetos por reciclaje (hit), 0 si hubo que alocar
+ * (miss) y -1 si malloc fallo.
+ */
+static int refill(SlabPool *p, WorkerCache *c) {
+    int result = 1;
+    pthread_mutex_lock(&p->mu);
+    if (p->global) {
+        while (p->global && c->count < SLAB_BATCH) {
+            FreeObj *o = p->global;
+            p->global = o->next;
+            p->global_count--;
+            o->next = c->head;
+            c->head = o;
+            c->count++;
+        }
+    } else {
+        Slab *s = malloc(offsetof(Slab, align) + p->obj_size * p->objs_per_slab);
+        if (!s) {
+            result = -1;
+        } else {
+            char *base = (char *)s + offsetof(Slab, align);
+            size_t i;
+            s->prev = p->slabs;
+            p->slabs = s;
+            p->nslabs++;
+            for (i = p->objs_per_slab; i > 0; i--) {
+                FreeObj *o = (FreeObj *)(base + (i - 1) * p->obj_size);
+                o->next = c->head;
+                c->head = o;
+                c->count++;
+            }
+            result = 0;
+        }
+    }
+    pthread_mutex_unlock(&p->mu);
+    return result;
+}
+
+/*
+ * spill — Devuelve a la lista global los objetos que superen
+ * SLAB_BATCH en la lista de un worker, en un solo lock.
+ */
+static void spill(SlabPool *p, WorkerCache *c) {
+    FreeObj *first, *last;
+    size_t n = 0;
+    if (c->count <= SLAB_CACHE_MAX) return;
+    first = last = c->head;
+    while (++n < c->count - SLAB_BATCH) last = last->next;
+    c->head = last->next;
+    c->count = SLAB_BATCH;
+    pthread_mutex_lock(&p->mu);
+    last->next = p->global;
+    p->global = first;
+    p->global_count += n;
+    pthread_mutex_unlock(&p->mu);
+}
+
+void *slab_alloc(SlabPool *p, int worker) {
+    WorkerCache *c = &p->caches[worker];
+    FreeObj *o;
+    uint64_t used, high;
+    if (!c->head) {
+        int r = refill(p, c);
+        if (r < 0) return NULL;
+        if (r == 0) c->misses++;
+        else c->hits++;
+    } else {
+        c->hits++;
+    }
+    o = c->head;
+    c->head = o->next;
+    c->count--;
+
+    used = __atomic_add_fetch(&p->in_use, 1, __ATOMIC_RELAXED);
+    high = __atomic_load_n(&p->high_water, __ATOMIC_RELAXED);
+    while (used > high &&
+           !__atomic_compare_exchange_n(&p->high_water, &high, used, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+    return o;
+}
+
+void slab_free(SlabPool *p, int worker, void *obj) {
+    slab_free_bulk(p, worker, &obj, 1);
+}
+
+void slab_free_bulk(SlabPool *p, int worker, void **objs, size_t n) {
+    WorkerCache *c = &p->caches[worker];
+    size_t i;
+    if (n == 0) return;
+    for (i = 0; i < n; i++) {
+        FreeObj *o = objs[i];
+        o->next = c->head;
+        c->head = o;
+    }
+    c->count += n;
+    __atomic_sub_fetch(&p->in_use, (uint64_t)n, __ATOMIC_RELAXED);
+    spill(p, c);
+}
+
+void slab_stats(const SlabPool *p, SlabStats *out) {
+    int i;
+    out->hits = 0;
+    out->misses = 0;
+    for (i = 0; i < p->nworkers; i++) {
+        out->hits += p->caches[i].hits;
+        out->misses += p->caches[i].misses;
+    }
+    out->in_use = __atomic_load_n(&p->in_use, __ATOMIC_RELAXED);
+    out->high_water = __atomic_load_n(&p->high_water, __ATOMIC_RELAXED);
+    out->slabs = p->nslabs;
+}
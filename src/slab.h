@@ -0,0 +1,84 @@
+/*
+ * slab.h — Pool de objetos de tamanio fijo para engines con tiles.
+ *
+ * Un engine que crea y destruye tiles a medida que los patrones se
+ * desplazan no deberia pagar malloc/free en cada generacion. SlabPool
+ * aloca los objetos de a slabs (bloques de muchos objetos contiguos) y
+ * recicla los liberados en listas enlazadas dentro de los propios
+ * objetos, sin memoria adicional:
+ *   - Cada worker (el indice de ParallelFn) tiene su propia lista libre,
+ *     que usa sin locks.
+ *   - Una lista global protegida por mutex intercambia lotes de objetos
+ *     con las listas de los workers: cuando una se vacia toma un lote,
+ *     cuando crece demasiado devuelve uno.
+ *   - Solo si la lista global tambien esta vacia se aloca un slab nuevo.
+ * Los slabs no se devuelven al sistema hasta slab_destroy.
+ *
+ * Un worker solo puede usar su propio indice, y dos threads no pueden
+ * usar el mismo indice a la vez.
+ */
+
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stddef.h>  /* size_t */
+#include <stdint.h>  /* uint64_t */
+
+typedef struct SlabPool SlabPool;
+
+/*
+ * SlabStats — Contadores acumulados del pool.
+ *
+ * hits       — Alocaciones servidas por una lista libre (sin malloc).
+ * misses     — Alocaciones que necesitaron un slab nuevo.
+ * in_use     — Objetos entregados y todavia no liberados.
+ * high_water — Maximo de in_use desde la creacion del pool.
+ * slabs      — Slabs alocados (cada uno con objs_per_slab objetos).
+ */
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t in_use;
+    uint64_t high_water;
+    uint64_t slabs;
+} SlabStats;
+
+/*
+ * slab_create — Pool de objetos de obj_size bytes, alocados de a
+ * objs_per_slab, con listas libres para nworkers workers (indices
+ * 0..nworkers-1). Retorna NULL si falla la alocacion.
+ */
+SlabPool *slab_create(size_t obj_size, size_t objs_per_slab, int nworkers);
+
+/*
+ * slab_destroy — Libera todos los slabs, incluidos los objetos que
+ * sigan en uso. Acepta NULL.
+ */
+void slab_destroy(SlabPool *pool);
+
+/*
+ * slab_alloc — Objeto para el worker dado, con contenido indefinido.
+ * Retorna NULL si hace falta un slab nuevo y malloc falla.
+ */
+void *slab_alloc(SlabPool *pool, int worker);
+
+/*
+ * slab_free — Devuelve un objeto a la lista libre del worker.
+ */
+void slab_free(SlabPool *pool, int worker, void *obj);
+
+/*
+ * slab_free_bulk — Devuelve n objetos de una vez: se encadenan sin
+ * tocar la lista global y, si la lista del worker queda demasiado
+ * larga, el excedente pasa a la global en un solo lock.
+ */
+void slab_free_bulk(SlabPool *pool, int worker, void **objs, size_t n);
+
+/*
+ * slab_stats — Lee los contadores. Los de hits y misses son por worker
+ * y se suman sin sincronizar: el valor es exacto si no hay alocaciones
+ * en curso.
+ */
+void slab_stats(const SlabPool *pool, SlabStats *out);
+
+#endif
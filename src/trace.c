@@ -0,0 +1,126 @@
+/*
+ * trace.c — Ring buffer de eventos y escritura del JSON de trace.h.
+ *
+ * El indice de escritura es un contador atomico de 64 bits que nunca se
+ * reinicia: el evento i va al slot i % TRACE_CAPACITY. Al escribir el
+ * archivo, si el contador supero la capacidad, los eventos validos son
+ * los TRACE_CAPACITY ultimos, empezando por el slot del contador.
+ *
+ * Los timestamps se guardan en nanosegundos desde trace_open y se
+ * escriben en microsegundos con decimales, la unidad del formato.
+ */
+
+#define _POSIX_C_SOURCE 200809L  /* clock_gettime, CLOCK_MONOTONIC */
+
+#include <stdio.h>   /* fopen, fprintf */
+#include <stdlib.h>  /* malloc, free */
+#include <string.h>  /* strlen, memcpy */
+#include <time.h>   /* clock_gettime */
+#include "trace.h"
+
+/* Threads distintos que se nombran en los metadatos del archivo */
+#define TRACE_MAX_TIDS 256
+
+/*
+ * TraceEvent — Un evento completo ("ph": "X") del ring buffer.
+ */
+typedef struct {
+    uint64_t begin;   /* ns desde trace_open */
+    uint64_t dur;     /* ns */
+    int tid;
+    int name;
+} TraceEvent;
+
+int trace_enabled = 0;
+
+static TraceEvent *events;
+static uint64_t next_event;  /* Atomico */
+static uint64_t origin;
+static char *out_path;
+
+static const char *const trace_names[TRACE_NAME_COUNT] = {
+    "step", "chunk", "barrier", "events", "render", "present", "snapshot"
+};
+
+uint64_t trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+int trace_open(const char *path) {
+    size_t len = strlen(path);
+    events = malloc(sizeof(TraceEvent) * TRACE_CAPACITY);
+    out_path = malloc(len + 1);
+    if (!events || !out_path) {
+        free(events);
+        free(out_path);
+        events = NULL;
+        out_path = NULL;
+        return 0;
+    }
+    memcpy(out_path, path, len + 1);
+    next_event = 0;
+    origin = trace_now();
+    trace_enabled = 1;
+    return 1;
+}
+
+void trace_record(TraceName name, int tid, uint64_t begin, uint64_t end) {
+    uint64_t i = __atomic_fetch_add(&next_event, 1, __ATOMIC_RELAXED);
+    TraceEvent *e = &events[i & (TRACE_CAPACITY - 1)];
+    e->begin = begin - origin;
+    e->dur = end - begin;
+    e->tid = tid;
+    e->name = (int)name;
+}
+
+/*
+ * write_json — Metadatos con el nombre de cada thread visto y los
+ * eventos en orden de registro.
+ */
+static int write_json(FILE *f) {
+    uint64_t count = __atomic_load_n(&next_event, __ATOMIC_ACQUIRE);
+    uint64_t first = count > TRACE_CAPACITY ? count - TRACE_CAPACITY : 0;
+    unsigned char seen[TRACE_MAX_TIDS] = {0};
+    uint64_t i;
+    int tid, sep = 0;
+
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (i = first; i < count; i++) {
+        tid = events[i & (TRACE_CAPACITY - 1)].tid;
+        if (tid >= 0 && tid < TRACE_MAX_TIDS) seen[tid] = 1;
+    }
+    for (tid = 0; tid < TRACE_MAX_TIDS; tid++) {
+        if (!seen[tid]) continue;
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                   "\"args\":{\"name\":\"%s %d\"}}",
+                sep ? ",\n" : "", tid, tid ? "worker" : "main", tid);
+        sep = 1;
+    }
+    for (i = first; i < count; i++) {
+        const TraceEvent *e = &events[i & (TRACE_CAPACITY - 1)];
+        fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                   "\"ts\":%.3f,\"dur\":%.3f}",
+                sep ? ",\n" : "", trace_names[e->name], e->tid,
+                (double)e->begin / 1e3, (double)e->dur / 1e3);
+        sep = 1;
+    }
+    fprintf(f, "\n]}\n");
+    return !ferror(f);
+}
+
+int trace_close(void) {
+    FILE *f;
+    int ok;
+    if (!trace_enabled) return 1;
+    trace_enabled = 0;
+    f = fopen(out_path, "w");
+    ok = f && write_json(f);
+    if (f && fclose(f) != 0) ok = 0;
+    free(events);
+    free(out_path);
+    events = NULL;
+    out_path = NULL;
+    return ok;
+}
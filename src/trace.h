@@ -0,0 +1,80 @@
+/*
+ * trace.h — Export de fases en formato Chrome trace-event (JSON).
+ *
+ * Con --trace FILE cada fase de interes se registra como un evento
+ * completo (inicio y duracion) con el thread que la ejecuto:
+ *   - step      — Una generacion en el thread principal.
+ *   - chunk     — El tramo de un pool_run que ejecuta cada worker (en un
+ *                 paso, las filas o tiles que le tocaron).
+ *   - barrier   — Espera del thread principal a que los demas workers
+ *                 terminen su tramo.
+ *   - events, render, present — Procesamiento de eventos SDL, dibujo
+ *                 del frame y SDL_RenderPresent (que con vsync espera el
+ *                 retrazado).
+ *   - snapshot  — Escritura del archivo de snapshot.
+ * El archivo se abre con chrome://tracing o https://ui.perfetto.dev y
+ * muestra una fila por thread: solapamientos, desbalance entre workers
+ * y esperas quedan a la vista.
+ *
+ * Los eventos van a un ring buffer de tamanio fijo alocado al abrir:
+ * registrar uno es leer el reloj y un incremento atomico, sin locks ni
+ * I/O; el JSON se escribe recien en trace_close. Si una corrida produce
+ * mas eventos que TRACE_CAPACITY, se conservan los ultimos. Con el trace
+ * cerrado, cada punto instrumentado cuesta solo un branch.
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>  /* uint64_t */
+
+/* Eventos que guarda el ring buffer (potencia de 2) */
+#define TRACE_CAPACITY (1u << 18)
+
+/*
+ * TraceName — Fases registrables (ver la lista de arriba).
+ */
+typedef enum {
+    TRACE_STEP,
+    TRACE_CHUNK,
+    TRACE_BARRIER,
+    TRACE_EVENTS,
+    TRACE_RENDER,
+    TRACE_PRESENT,
+    TRACE_SNAPSHOT,
+    TRACE_NAME_COUNT
+} TraceName;
+
+/* Distinto de 0 entre trace_open y trace_close */
+extern int trace_enabled;
+
+/*
+ * trace_open — Aloca el ring buffer y empieza a registrar; el JSON se
+ * escribira en path. Retorna 0 si falla la alocacion.
+ */
+int trace_open(const char *path);
+
+/*
+ * trace_close — Deja de registrar, escribe el archivo y libera el
+ * buffer. Llamar con los pools de threads detenidos. Retorna 0 si el
+ * archivo no pudo escribirse. Sin trace abierto no hace nada y retorna 1.
+ */
+int trace_close(void);
+
+/*
+ * trace_now — Reloj monotonico en nanosegundos.
+ */
+uint64_t trace_now(void);
+
+/*
+ * trace_record — Registra la fase name del thread tid entre begin y end
+ * (valores de trace_now). Puede llamarse desde cualquier thread.
+ */
+void trace_record(TraceName name, int tid, uint64_t begin, uint64_t end);
+
+/* Marca el inicio de una fase en t y la registra al cerrarla */
+#define TRACE_BEGIN(t) uint64_t t = trace_enabled ? trace_now() : 0
+#define TRACE_END(name, tid, t) \
+    do { if (trace_enabled) trace_record((name), (tid), (t), trace_now()); } while (0)
+
+#endif
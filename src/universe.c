@@ -0,0 +1,500 @@
+/*
+ * universe.c — Implementacion del plano infinito por tiles.
+ *
+ * Estructuras internas:
+ *   - UTile: un tile de 64x64 celdas con dos generaciones de filas
+ *     (rows[0] y rows[1]); la actual es rows[u->phase] para todos los
+ *     tiles a la vez, asi que el "swap" de buffers es cambiar phase.
+ *     En cada fila el bit x es la columna x del tile (bit 0 = izquierda).
+ *   - Tabla hash: direccionamiento abierto con sondeo lineal sobre
+ *     punteros a tile, indexada por (tx, ty). El borrado desplaza hacia
+ *     atras los elementos siguientes del cluster, sin lapidas.
+ *   - Lista densa de tiles (tiles[0..ntiles)), para recorrerlos y
+ *     repartirlos entre threads sin barrer la tabla. Cada tile guarda su
+ *     indice en la lista para poder quitarlo en O(1).
+ *   - Los tiles salen de un SlabPool (slab.h): crear y liberar tiles al
+ *     paso de los gliders recicla memoria sin llamar a malloc/free. La
+ *     tabla y la lista solo se modifican desde el thread que llama a
+ *     universe_step, asi que se usa la lista libre del worker 0; los
+ *     tiles que quedan vacios en un paso se devuelven todos juntos.
+ *
+ * Kernel bit-paralelo: una fila de 64 celdas se calcula con operaciones
+ * logicas sobre palabras. Los 8 vecinos de cada bit son las palabras de
+ * las filas de arriba, del medio y de abajo desplazadas un bit a cada
+ * lado (completando con el bit de borde del tile vecino). Un sumador
+ * bit a bit cuenta los vecinos sin separar las celdas: 64 celdas por
+ * unas 30 operaciones.
+ */
+
+#include <stdlib.h>  /* malloc, calloc, free */
+#include <string.h>  /* memset, memcpy */
+#include "universe.h"
+#include "profile.h"
+#include "trace.h"
+#include "rng.h"
+
+/* Filas por tile y mascara de coordenada local */
+#define TILE UNIVERSE_TILE
+#define TILE_MASK (UNIVERSE_TILE - 1)
+
+/* Slots iniciales de la tabla hash (potencia de 2) */
+#define INITIAL_SLOTS 256
+
+/* Tiles por tramo minimo al repartir universe_step entre threads */
+#define STEP_GRAIN_TILES 16
+
+/* Tiles por slab del pool (~66 KiB por slab) */
+#define TILES_PER_SLAB 64
+
+typedef struct UTile {
+    int64_t tx, ty;        /* Coordenadas del tile (celda / 64) */
+    size_t index;          /* Posicion en Universe::tiles */
+    int live;              /* Hay celdas vivas en la generacion actual */
+    uint64_t rows[2][TILE];
+} UTile;
+
+struct Universe {
+    UTile **slots;         /* Tabla hash (NULL = slot libre) */
+    size_t cap;            /* Capacidad de la tabla (potencia de 2) */
+    UTile **tiles;         /* Lista densa de tiles alocados */
+    size_t ntiles;
+    size_t tiles_cap;
+    UTile **dead;          /* Tiles a liberar en bloque (capacidad tiles_cap) */
+    SlabPool *tile_pool;   /* Memoria de los tiles */
+    int phase;             /* Generacion actual: rows[phase] */
+    ThreadPool *pool;
+};
+
+/*
+ * tile_coord — Coordenada de tile de una celda: division entera por 64
+ * redondeando hacia -infinito, tambien para celdas negativas.
+ */
+static int64_t tile_coord(int64_t v) {
+    return (v - (v & TILE_MASK)) / TILE;
+}
+
+/*
+ * hash_tile — Mezcla las coordenadas del tile con el finalizador de
+ * SplitMix64, que dispersa bien coordenadas vecinas.
+ */
+static size_t hash_tile(int64_t tx, int64_t ty) {
+    return (size_t)rng_mix64((uint64_t)tx * 0x9E3779B97F4A7C15ull ^ (uint64_t)ty);
+}
+
+/*
+ * find_tile — Tile (tx, ty) o NULL si no existe.
+ */
+static UTile *find_tile(const Universe *u, int64_t tx, int64_t ty) {
+    size_t i = hash_tile(tx, ty) & (u->cap - 1);
+    while (u->slots[i]) {
+        if (u->slots[i]->tx == tx && u->slots[i]->ty == ty) return u->slots[i];
+        i = (i + 1) & (u->cap - 1);
+    }
+    return NULL;
+}
+
+/*
+ * table_put — Inserta t en una tabla que no lo contiene.
+ */
+static void table_put(UTile **slots, size_t cap, UTile *t) {
+    size_t i = hash_tile(t->tx, t->ty) & (cap - 1);
+    while (slots[i]) i = (i + 1) & (cap - 1);
+    slots[i] = t;
+}
+
+/*
+ * table_remove — Quita t de la tabla con borrado por desplazamiento:
+ * cada elemento posterior del cluster cuyo slot ideal no quede entre el
+ * hueco y su posicion actual se mueve al hueco.
+ */
+static void table_remove(Universe *u, UTile *t) {
+    size_t mask = u->cap - 1;
+    size_t i = hash_tile(t->tx, t->ty) & mask;
+    size_t j;
+    while (u->slots[i] != t) i = (i + 1) & mask;
+    u->slots[i] = NULL;
+    for (j = (i + 1) & mask; u->slots[j]; j = (j + 1) & mask) {
+        size_t k = hash_tile(u->slots[j]->tx, u->slots[j]->ty) & mask;
+        /* k en (i, j] de forma circular: el elemento puede quedarse */
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+        u->slots[i] = u->slots[j];
+        u->slots[j] = NULL;
+        i = j;
+    }
+}
+
+/*
+ * grow — Duplica la tabla al superar el 50% de ocupacion.
+ */
+static int grow(Universe *u) {
+    size_t ncap = u->cap * 2, i;
+    UTile **ns = calloc(ncap, sizeof(UTile *));
+    if (!ns) return 0;
+    for (i = 0; i < u->cap; i++)
+        if (u->slots[i]) table_put(ns, ncap, u->slots[i]);
+    free(u->slots);
+    u->slots = ns;
+    u->cap = ncap;
+    return 1;
+}
+
+/*
+ * ensure_tile — Tile (tx, ty), creandolo vacio si no existe. Los tiles
+ * nuevos salen del SlabPool. Retorna NULL si falla la alocacion.
+ */
+static UTile *ensure_tile(Universe *u, int64_t tx, int64_t ty) {
+    UTile *t = find_tile(u, tx, ty);
+    if (t) return t;
+    if ((u->ntiles + 1) * 2 > u->cap && !grow(u)) return NULL;
+    if (u->ntiles == u->tiles_cap) {
+        size_t ncap = u->tiles_cap ? u->tiles_cap * 2 : INITIAL_SLOTS;
+        UTile **nt = realloc(u->tiles, ncap * sizeof(UTile *));
+        UTile **nd;
+        if (!nt) return NULL;
+        u->tiles = nt;
+        nd = realloc(u->dead, ncap * sizeof(UTile *));
+        if (!nd) return NULL;
+        u->dead = nd;
+        u->tiles_cap = ncap;
+    }
+    t = slab_alloc(u->tile_pool, 0);
+    if (!t) return NULL;
+    memset(t->rows, 0, sizeof(t->rows));
+    t->tx = tx;
+    t->ty = ty;
+    t->live = 0;
+    t->index = u->ntiles;
+    u->tiles[u->ntiles++] = t;
+    table_put(u->slots, u->cap, t);
+    return t;
+}
+
+/*
+ * detach_tile — Quita t de la tabla y de la lista densa (moviendo el
+ * ultimo a su lugar). La memoria la devuelve quien llama.
+ */
+static void detach_tile(Universe *u, UTile *t) {
+    UTile *last = u->tiles[--u->ntiles];
+    table_remove(u, t);
+    last->index = t->index;
+    u->tiles[t->index] = last;
+}
+
+Universe *universe_create(void) {
+    Universe *u = malloc(sizeof(Universe));
+    if (!u) return NULL;
+    u->cap = INITIAL_SLOTS;
+    u->slots = calloc(u->cap, sizeof(UTile *));
+    u->tiles = NULL;
+    u->ntiles = 0;
+    u->tiles_cap = 0;
+    u->dead = NULL;
+    u->phase = 0;
+    u->pool = NULL;
+    u->tile_pool = slab_create(sizeof(UTile), TILES_PER_SLAB, 1);
+    if (!u->slots || !u->tile_pool) {
+        free(u->slots);
+        slab_destroy(u->tile_pool);
+        free(u);
+        return NULL;
+    }
+    return u;
+}
+
+/*
+ * universe_destroy — slab_destroy libera la memoria de todos los tiles
+ * de una vez, sin recorrerlos.
+ */
+void universe_destroy(Universe *u) {
+    if (!u) return;
+    slab_destroy(u->tile_pool);
+    free(u->tiles);
+    free(u->dead);
+    free(u->slots);
+    pool_destroy(u->pool);
+    free(u);
+}
+
+int universe_set_threads(Universe *u, int nthreads) {
+    pool_destroy(u->pool);
+    u->pool = NULL;
+    if (nthreads <= 1) return 1;
+    u->pool = pool_create(nthreads);
+    return u->pool != NULL;
+}
+
+void universe_clear(Universe *u) {
+    size_t n = u->ntiles;
+    if (n == 0) return;
+    memcpy(u->dead, u->tiles, n * sizeof(UTile *));
+    u->ntiles = 0;
+    memset(u->slots, 0, u->cap * sizeof(UTile *));
+    slab_free_bulk(u->tile_pool, 0, (void **)u->dead, n);
+}
+
+int universe_set_cell(Universe *u, int64_t x, int64_t y, int alive) {
+    UTile *t;
+    uint64_t bit = (uint64_t)1 << (x & TILE_MASK);
+    if (!alive) {
+        t = find_tile(u, tile_coord(x), tile_coord(y));
+        if (t) t->rows[u->phase][y & TILE_MASK] &= ~bit;
+        return 1;
+    }
+    t = ensure_tile(u, tile_coord(x), tile_coord(y));
+    if (!t) return 0;
+    t->rows[u->phase][y & TILE_MASK] |= bit;
+    t->live = 1;
+    return 1;
+}
+
+int universe_get_cell(const Universe *u, int64_t x, int64_t y) {
+    const UTile *t = find_tile(u, tile_coord(x), tile_coord(y));
+    if (!t) return 0;
+    return (int)((t->rows[u->phase][y & TILE_MASK] >> (x & TILE_MASK)) & 1u);
+}
+
+/*
+ * expand — Crea los vecinos que pueden recibir nacimientos: un tile con
+ * celdas vivas en su fila superior necesita al de arriba, con celdas en
+ * la columna 0 al de la izquierda, y asi; las esquinas vivas piden los
+ * diagonales. Solo se recorren los tiles existentes al comenzar (los
+ * creados aqui estan vacios y no expanden).
+ */
+static int expand(Universe *u) {
+    size_t n = u->ntiles, i;
+    int r;
+    for (i = 0; i < n; i++) {
+        UTile *t = u->tiles[i];
+        const uint64_t *rows = t->rows[u->phase];
+        uint64_t left = 0, right = 0;
+        int64_t tx = t->tx, ty = t->ty;
+        if (!t->live) continue;
+        for (r = 0; r < TILE; r++) {
+            left |= rows[r] & 1u;
+            right |= rows[r] >> (TILE - 1);
+        }
+        /* ensure_tile puede mover la lista: t no se usa despues */
+        if (rows[0] && !ensure_tile(u, tx, ty - 1)) return 0;
+        if (rows[TILE - 1] && !ensure_tile(u, tx, ty + 1)) return 0;
+        if (left && !ensure_tile(u, tx - 1, ty)) return 0;
+        if (right && !ensure_tile(u, tx + 1, ty)) return 0;
+        if ((rows[0] & 1u) && !ensure_tile(u, tx - 1, ty - 1)) return 0;
+        if ((rows[0] >> (TILE - 1)) && !ensure_tile(u, tx + 1, ty - 1)) return 0;
+        if ((rows[TILE - 1] & 1u) && !ensure_tile(u, tx - 1, ty + 1)) return 0;
+        if ((rows[TILE - 1] >> (TILE - 1)) && !ensure_tile(u, tx + 1, ty + 1)) return 0;
+    }
+    return 1;
+}
+
+/*
+ * neighbor_row — Fila r de la generacion actual del tile (tx, ty), o 0
+ * si el tile no existe.
+ */
+static uint64_t neighbor_row(const Universe *u, const UTile *t, int r) {
+    return t ? t->rows[u->phase][r] : 0;
+}
+
+/*
+ * step_tile — Calcula la generacion siguiente de un tile.
+ *
+ * Se arman las 66 filas (la de arriba del tile, sus 64 y la de abajo)
+ * con sus versiones desplazadas: west[i] tiene en el bit x la celda
+ * x - 1 y east[i] la celda x + 1, completadas con las columnas de
+ * borde de los tiles vecinos. Luego, por fila:
+ *   - arriba y abajo suman 3 bits cada una (west, centro, east) en un
+ *     numero de 2 bits; el medio suma 2 (west, east).
+ *   - Las tres sumas se combinan: s0 es el bit de unidades del total y
+ *     twos cuenta los "2" (a1, b1, m1 y el acarreo c0).
+ *   - Con total = s0 + 2 * twos, la celda queda viva si total == 3 o si
+ *     total == 2 y estaba viva: exactamente un "2" y (s0 o viva).
+ */
+static void step_tile(const Universe *u, UTile *t) {
+    const UTile *n = find_tile(u, t->tx, t->ty - 1);
+    const UTile *s = find_tile(u, t->tx, t->ty + 1);
+    const UTile *w = find_tile(u, t->tx - 1, t->ty);
+    const UTile *e = find_tile(u, t->tx + 1, t->ty);
+    const UTile *nw = find_tile(u, t->tx - 1, t->ty - 1);
+    const UTile *ne = find_tile(u, t->tx + 1, t->ty - 1);
+    const UTile *sw = find_tile(u, t->tx - 1, t->ty + 1);
+    const UTile *se = find_tile(u, t->tx + 1, t->ty + 1);
+    const uint64_t *cur = t->rows[u->phase];
+    uint64_t *out = t->rows[u->phase ^ 1];
+    uint64_t mid[TILE + 2], west[TILE + 2], east[TILE + 2];
+    uint64_t any = 0;
+    int i;
+
+    /* Fila 0 del arreglo = fila 63 de los tiles de arriba */
+    mid[0] = neighbor_row(u, n, TILE - 1);
+    west[0] = (mid[0] << 1) | (neighbor_row(u, nw, TILE - 1) >> (TILE - 1));
+    east[0] = (mid[0] >> 1) | (neighbor_row(u, ne, TILE - 1) << (TILE - 1));
+    for (i = 0; i < TILE; i++) {
+        mid[i + 1] = cur[i];
+        west[i + 1] = (cur[i] << 1) | (neighbor_row(u, w, i) >> (TILE - 1));
+        east[i + 1] = (cur[i] >> 1) | (neighbor_row(u, e, i) << (TILE - 1));
+    }
+    mid[TILE + 1] = neighbor_row(u, s, 0);
+    west[TILE + 1] = (mid[TILE + 1] << 1) | (neighbor_row(u, sw, 0) >> (TILE - 1));
+    east[TILE + 1] = (mid[TILE + 1] >> 1) | (neighbor_row(u, se, 0) << (TILE - 1));
+
+    for (i = 1; i <= TILE; i++) {
+        uint64_t a0, a1, b0, b1, m0, m1, s0, c0, p, q, one_two;
+        /* Fila de arriba: west + centro + east */
+        a0 = west[i - 1] ^ mid[i - 1] ^ east[i - 1];
+        a1 = (west[i - 1] & mid[i - 1]) | (east[i - 1] & (west[i - 1] ^ mid[i - 1]));
+        /* Fila de abajo */
+        b0 = west[i + 1] ^ mid[i + 1] ^ east[i + 1];
+        b1 = (west[i + 1] & mid[i + 1]) | (east[i + 1] & (west[i + 1] ^ mid[i + 1]));
+        /* Fila del medio: solo west + east */
+        m0 = west[i] ^ east[i];
+        m1 = west[i] & east[i];
+        /* Unidades y acarreo hacia los "2" */
+        s0 = a0 ^ b0 ^ m0;
+        c0 = (a0 & b0) | (m0 & (a0 ^ b0));
+        /* Exactamente uno de a1, b1, m1, c0 */
+        p = a1 ^ b1;
+        q = m1 ^ c0;
+        one_two = (p ^ q) & ~((a1 & b1) | (m1 & c0));
+        out[i - 1] = one_two & (s0 | mid[i]);
+        any |= out[i - 1];
+    }
+    t->live = any != 0;
+}
+
+/*
+ * step_tiles — Trabajo paralelo: cada tile escribe solo sus propias
+ * filas de la generacion siguiente y la tabla no cambia durante el
+ * calculo, asi que los tramos no necesitan sincronizacion.
+ */
+static void step_tiles(void *ctx, size_t begin, size_t end, int worker) {
+    Universe *u = ctx;
+    size_t i;
+    (void)worker;
+    for (i = begin; i < end; i++) step_tile(u, u->tiles[i]);
+}
+
+/*
+ * universe_step — Expansion, calculo de todos los tiles y cambio de
+ * fase. Los tiles que quedaron vacios se devuelven al SlabPool en un
+ * solo slab_free_bulk; si un vecino vuelve a necesitarlos, expand los
+ * recrea en el paso siguiente desde la lista libre.
+ */
+int universe_step(Universe *u) {
+    size_t i, ndead = 0;
+    TRACE_BEGIN(tt);
+    PROFILE_START(t);
+    if (!expand(u)) return 0;
+    pool_run(u->pool, u->ntiles, STEP_GRAIN_TILES, step_tiles, u);
+    u->phase ^= 1;
+    for (i = u->ntiles; i > 0; i--) {
+        UTile *t = u->tiles[i - 1];
+        if (!t->live) {
+            detach_tile(u, t);
+            u->dead[ndead++] = t;
+        }
+    }
+    slab_free_bulk(u->tile_pool, 0, (void **)u->dead, ndead);
+    PROFILE_STOP(PROFILE_STEP, t);
+    TRACE_END(TRACE_STEP, 0, tt);
+    return 1;
+}
+
+/*
+ * popcount64 — Bits en 1 de una palabra (suma en paralelo por campos).
+ */
+static int popcount64(uint64_t v) {
+    v = v - ((v >> 1) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+    v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((v * 0x0101010101010101ull) >> 56);
+}
+
+uint64_t universe_population(const Universe *u) {
+    uint64_t pop = 0;
+    size_t i;
+    int r;
+    for (i = 0; i < u->ntiles; i++)
+        for (r = 0; r < TILE; r++) pop += (uint64_t)popcount64(u->tiles[i]->rows[u->phase][r]);
+    return pop;
+}
+
+size_t universe_tile_count(const Universe *u) {
+    return u->ntiles;
+}
+
+/*
+ * universe_memory — Slabs de tiles (en uso o en listas libres), tabla
+ * hash y listas tiles/dead.
+ */
+size_t universe_memory(const Universe *u) {
+    SlabStats s;
+    slab_stats(u->tile_pool, &s);
+    return (size_t)s.slabs * TILES_PER_SLAB * sizeof(UTile) +
+           (u->cap + 2 * u->tiles_cap) * sizeof(UTile *);
+}
+
+void universe_pool_stats(const Universe *u, SlabStats *out) {
+    slab_stats(u->tile_pool, out);
+}
+
+/*
+ * universe_hash — Cada tile con celdas produce un hash propio
+ * (coordenadas y filas encadenadas con mix64) y los hashes de tile se
+ * suman: la suma es conmutativa, asi que el resultado no depende del
+ * orden de la lista densa.
+ */
+uint64_t universe_hash(const Universe *u) {
+    uint64_t h = 0;
+    size_t i;
+    int r;
+    for (i = 0; i < u->ntiles; i++) {
+        const UTile *t = u->tiles[i];
+        uint64_t th;
+        if (!t->live) continue;
+        th = hash_tile(t->tx, t->ty);
+        for (r = 0; r < TILE; r++) th = rng_mix64(th ^ t->rows[u->phase][r]);
+        h += th;
+    }
+    return h;
+}
+
+/*
+ * universe_from_game — Recorre el grid fila por fila y solo toca la
+ * tabla para las celdas vivas.
+ */
+int universe_from_game(Universe *u, Game *g, int64_t ox, int64_t oy) {
+    int x, y;
+    universe_clear(u);
+    for (y = 0; y < g->height; y++) {
+        for (x = 0; x < g->width; x++) {
+            if (game_get_cell(g, x, y) && !universe_set_cell(u, ox + x, oy + y, 1))
+                return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * universe_to_game — Limpia el grid y copia cada tile que intersecta la
+ * ventana con un game_write_bits: las filas del tile (bit b = columna b)
+ * se pasan a un bitmap de 8 bytes por fila, que game_write_bits recorta
+ * contra los bordes. El costo es O(grid) por el clear mas O(tiles
+ * alocados), sin importar lo lejos que esten los tiles.
+ */
+void universe_to_game(const Universe *u, Game *g, int64_t ox, int64_t oy) {
+    unsigned char bits[TILE][TILE / 8];
+    size_t i;
+    int r, b;
+    game_clear(g);
+    for (i = 0; i < u->ntiles; i++) {
+        const UTile *t = u->tiles[i];
+        int64_t x0 = t->tx * TILE - ox, y0 = t->ty * TILE - oy;
+        if (!t->live || x0 >= g->width || y0 >= g->height ||
+            x0 + TILE <= 0 || y0 + TILE <= 0)
+            continue;
+        for (r = 0; r < TILE; r++) {
+            uint64_t row = t->rows[u->phase][r];
+            for (b = 0; b < TILE / 8; b++) bits[r][b] = (unsigned char)(row >> (8 * b));
+        }
+        game_write_bits(g, (int)x0, (int)y0, TILE, TILE, &bits[0][0], TILE / 8, GAME_BLEND_COPY);
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * universe.h — Plano infinito (sin bordes) con tiles dispersos.
+ *
+ * A diferencia de Game, que simula un grid fijo de width x height con
+ * bordes muertos, un Universe no tiene limites: las coordenadas son
+ * int64_t y solo existe memoria para las zonas con actividad.
+ *
+ * El plano se divide en tiles de UNIVERSE_TILE x UNIVERSE_TILE celdas,
+ * guardados como un bit por celda (una palabra de 64 bits por fila). Los
+ * tiles viven en una tabla hash indexada por sus coordenadas de tile:
+ *   - Antes de cada paso se crean los vecinos de todo tile que tenga
+ *     celdas vivas en el borde que los toca (solo ahi puede nacer algo).
+ *   - Despues del paso, los tiles que quedaron vacios se devuelven a un
+ *     SlabPool (slab.h), de donde se reutilizan sin pasar por malloc.
+ * Asi la memoria y el tiempo por generacion son proporcionales al area
+ * activa, no al bounding box: dos gliders a 10^9 celdas de distancia
+ * cuestan lo mismo que dos gliders vecinos.
+ *
+ * Para mostrarlo, universe_to_game copia una ventana del plano en un
+ * Game del tamanio de la pantalla.
+ */
+
+#ifndef UNIVERSE_H
+#define UNIVERSE_H
+
+#include <stdint.h>  /* int64_t, uint64_t */
+#include <stddef.h>  /* size_t */
+#include "game.h"
+#include "slab.h"
+
+/* Lado de un tile en celdas: una fila es exactamente un uint64_t */
+#define UNIVERSE_TILE 64
+
+typedef struct Universe Universe;
+
+/*
+ * universe_create — Universo vacio. Retorna NULL si falla la alocacion.
+ */
+Universe *universe_create(void);
+
+/*
+ * universe_destroy — Libera tiles, pool y tabla. Acepta NULL.
+ */
+void universe_destroy(Universe *u);
+
+/*
+ * universe_set_threads — Threads para universe_step, igual que
+ * game_set_threads. Retorna 1 en exito, 0 si no pudo crearse el pool.
+ */
+int universe_set_threads(Universe *u, int nthreads);
+
+/*
+ * universe_clear — Mata todas las celdas (los tiles vuelven al pool).
+ */
+void universe_clear(Universe *u);
+
+/*
+ * universe_set_cell — Establece la celda (x, y). Crea el tile si hace
+ * falta. Retorna 0 si la alocacion falla, 1 en exito.
+ */
+int universe_set_cell(Universe *u, int64_t x, int64_t y, int alive);
+
+/*
+ * universe_get_cell — Estado de la celda (x, y); 0 si no hay tile.
+ */
+int universe_get_cell(const Universe *u, int64_t x, int64_t y);
+
+/*
+ * universe_step — Avanza una generacion en todo el plano.
+ * Retorna 0 si no pudo alocarse un tile nuevo (la generacion no se
+ * avanza), 1 en exito.
+ */
+int universe_step(Universe *u);
+
+/*
+ * universe_population — Cantidad de celdas vivas.
+ */
+uint64_t universe_population(const Universe *u);
+
+/*
+ * universe_tile_count — Tiles alocados (los vacios ya fueron liberados
+ * tras el ultimo paso, salvo los creados para recibir nacimientos).
+ */
+size_t universe_tile_count(const Universe *u);
+
+/*
+ * universe_memory — Bytes alocados para tiles y tablas, incluidos los
+ * tiles libres que el pool conserva para reutilizar.
+ */
+size_t universe_memory(const Universe *u);
+
+/*
+ * universe_pool_stats — Contadores del pool de tiles: reciclados (hits),
+ * slabs nuevos (misses) y maximo de tiles simultaneos (high_water).
+ */
+void universe_pool_stats(const Universe *u, SlabStats *out);
+
+/*
+ * universe_hash — Huella de 64 bits de las celdas vivas, independiente
+ * del orden interno de los tiles y de la cantidad de threads.
+ */
+uint64_t universe_hash(const Universe *u);
+
+/*
+ * universe_from_game — Reemplaza el contenido por el de g, con la celda
+ * (x, y) del grid en la coordenada (ox + x, oy + y) del plano.
+ * Retorna 0 si la alocacion falla.
+ */
+int universe_from_game(Universe *u, Game *g, int64_t ox, int64_t oy);
+
+/*
+ * universe_to_game — Copia en g la ventana del plano cuya esquina
+ * superior izquierda es (ox, oy): la celda (x, y) del grid pasa a ser
+ * la celda (ox + x, oy + y) del plano. Solo recorre los tiles alocados.
+ */
+void universe_to_game(const Universe *u, Game *g, int64_t ox, int64_t oy);
+
+#endif